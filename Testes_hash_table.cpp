@@ -1,483 +1,1229 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <iterator>
 #include <chrono>
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <string>
 #include <iomanip>
+#include <cstdint>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include <memory>
+#include <sstream>
+#include <fstream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HASH_MMAP 1
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HASH_PERF 1
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define HASH_X86 1
+#endif
 
 using namespace std;
 
 // HASH usado em todas as estratégias
-size_t calcularHash(int chave, size_t tamanhoTabela) {
+// Valor completo, antes de reduzir ao tamanho da tabela (cabe em 32 bits)
+unsigned long long hashCompleto(unsigned long long chave) {
     const unsigned long long a = 2654435761ULL;
     const unsigned long long b = 40503ULL;
     const unsigned long long p = 4294967291ULL;
     
-    unsigned long long valorHash = ((a * static_cast<unsigned long long>(chave) + b) % p);
+    return (a * chave + b) % p;
+}
+
+size_t calcularHash(unsigned long long chave, size_t tamanhoTabela) {
+    unsigned long long valorHash = hashCompleto(chave);
     return valorHash % tamanhoTabela;
 }
 
+// HASH DAS CHAVES
+// Converte a chave no valor de 64 bits guardado junto de cada elemento. As políticas
+// abaixo apenas reduzem esse valor ao tamanho da tabela, então o hash da chave é
+// calculado uma única vez por elemento, inclusive nos redimensionamentos.
+template <typename Chave, typename = void>
+struct HashChave {
+    size_t operator()(const Chave& chave) const { return hash<Chave>()(chave); }
+};
+
+// Inteiros: o próprio valor, a mistura fica a cargo da política
+template <typename Chave>
+struct HashChave<Chave, enable_if_t<is_integral<Chave>::value>> {
+    size_t operator()(Chave chave) const { return static_cast<size_t>(chave); }
+};
+
+// Texto: transparente, aceita string_view ou const char* na busca sem construir std::string
+template <>
+struct HashChave<string> {
+    using is_transparent = void;
+    size_t operator()(string_view texto) const { return hash<string_view>()(texto); }
+};
+
+// POLÍTICAS DE HASH
+// Cada política transforma o hash da chave em índice de balde e é parâmetro de template
+// das tabelas, então a escolha é resolvida em compilação e o cálculo é expandido em linha.
+// Interface: ajustar(tamanho) prepara constantes para o tamanho atual da tabela,
+// indice(hash) devolve o balde e capacidadeValida(pedida) arredonda a capacidade
+// para um tamanho que a política suporta.
+
+// Função original (referência): dois restos de divisão por chamada
+struct HashBase {
+    size_t tamanho = 1;
+
+    static size_t capacidadeValida(size_t pedida) { return max(pedida, (size_t)1); }
+    void ajustar(size_t novoTamanho) { tamanho = novoTamanho; }
+    size_t indice(size_t hash) const { return calcularHash(hash, tamanho); }
+};
+
+// Multiplicação e deslocamento (Knuth/Dietzfelbinger): exige tamanho potência de 2 e
+// usa os bits altos do produto, sem nenhuma divisão
+struct HashMultiplicativo {
+    unsigned deslocamento = 63;
+
+    static size_t capacidadeValida(size_t pedida) {
+        size_t capacidade = 2;
+        while (capacidade < pedida) {
+            capacidade *= 2;
+        }
+        return capacidade;
+    }
+
+    void ajustar(size_t novoTamanho) {
+        unsigned bits = 0;
+        while (((size_t)1 << bits) < novoTamanho) {
+            bits++;
+        }
+        deslocamento = 64 - bits;
+    }
+
+    size_t indice(size_t hash) const {
+        return (hash * 0x9E3779B97F4A7C15ULL) >> deslocamento;
+    }
+};
+
+// Redução fastrange de Lemire: mapeia um hash de 32 bits para [0, tamanho) com uma
+// multiplicação, para qualquer tamanho
+struct HashFastrange {
+    unsigned long long tamanho = 1;
+
+    static size_t capacidadeValida(size_t pedida) { return max(pedida, (size_t)1); }
+    void ajustar(size_t novoTamanho) { tamanho = novoTamanho; }
+
+    size_t indice(size_t hash) const {
+        // O fastrange usa os bits altos, por isso o hash é misturado antes
+        unsigned long long misturado = hash * 0x9E3779B97F4A7C15ULL;
+        return ((misturado >> 32) * tamanho) >> 32;
+    }
+};
+
+// Mesmo hash da referência, mas o resto pelo tamanho (primo) usa o recíproco
+// pré-calculado de Lemire (fastmod) no lugar da divisão de hardware
+struct HashPrimoReciproco {
+    unsigned long long tamanho = 1;
+    unsigned long long reciproco = 0;
+
+    static bool ehPrimo(size_t n) {
+        if (n < 2) return false;
+        for (size_t d = 2; d * d <= n; d++) {
+            if (n % d == 0) return false;
+        }
+        return true;
+    }
+
+    static size_t capacidadeValida(size_t pedida) {
+        size_t capacidade = max(pedida, (size_t)2);
+        while (!ehPrimo(capacidade)) {
+            capacidade++;
+        }
+        return capacidade;
+    }
+
+    void ajustar(size_t novoTamanho) {
+        tamanho = novoTamanho;
+        reciproco = ~0ULL / tamanho + 1;
+    }
+
+    size_t indice(size_t hash) const {
+        // hashCompleto cabe em 32 bits, condição do fastmod de 32 bits
+        unsigned long long fracao = reciproco * hashCompleto(hash);
+        return (unsigned long long)(((unsigned __int128)fracao * tamanho) >> 64);
+    }
+};
 
-// Estrutura para armazenar chave-valor
+
+// Estrutura para armazenar chave-valor. O hash completo da chave fica guardado: o
+// rehash não precisa recalculá-lo e as chaves só são comparadas quando os hashes batem
+template <typename Chave, typename Valor>
 struct Elemento {
-    int chave;
-    int valor;
-    Elemento(int c, int v) : chave(c), valor(v) {}
+    Chave chave;
+    Valor valor;
+    size_t hash;
+    Elemento(Chave c, Valor v, size_t h) : chave(move(c)), valor(move(v)), hash(h) {}
 };
 
-// Tabela HASH - ESTÁTICA
-class TabelaEstatica {
+// CONTAGEM DE MEMÓRIA
+// Toda alocação das tabelas (nós, vetores de baldes e de posições, tabela nova da
+// migração, cópia temporária do rehash, placas do pool) passa por aqui. Cada thread
+// conta numa linha de cache só sua, escrita só por ela, sem operação atômica de
+// leitura-modificação-escrita: as alocações dos laços medidos, e as das threads que usam
+// fragmentos diferentes da TabelaFragmentada, não disputam uma linha compartilhada.
+// ler() soma as threads (as encerradas ficam acumuladas). Bytes reservados somam a
+// sobra que o malloc arredonda e o cabeçalho de cada bloco, que os bytes pedidos não
+// mostram. O pico é exato enquanto uma thread só aloca; com várias, é a soma do pico de
+// cada uma, um limite superior.
+class MedidorMemoria {
 private:
-    vector<list<Elemento>> tabela;
-    size_t capacidade;
-    size_t elementos;
-    size_t colisoes;
-    
-public:
-    TabelaEstatica(size_t tamanhoFixo = 10007) : capacidade(tamanhoFixo), elementos(0), colisoes(0) {
-        tabela.resize(tamanhoFixo);
-    }
+    // vivos de uma thread fica negativo quando ela libera o que outra alocou
+    struct alignas(64) Contadores {
+        atomic<long long> vivos{0};
+        atomic<long long> pico{0};
+        atomic<long long> reservados{0};
+        atomic<size_t> alocacoes{0};
+        atomic<unsigned> epocaPico{0};  // pico vale só se igual à época global
+        Contadores* proximo = nullptr;
+    };
     
-    void inserir(int chave, int valor) {
-        size_t indice = calcularHash(chave, capacidade);
+    // Registra os contadores da thread na primeira alocação e, quando ela termina, passa o
+    // que contou para encerradas
+    struct Registro {
+        Contadores* contadores;
         
-        for (auto& elem : tabela[indice]) {
-            if (elem.chave == chave) {
-                elem.valor = valor;
-                return;
-            }
+        Registro() : contadores(new Contadores) {
+            lock_guard<mutex> guarda(trava);
+            contadores->proximo = primeira;
+            primeira = contadores;
         }
         
-        if (!tabela[indice].empty()) {
-            colisoes++;
+        ~Registro() {
+            lock_guard<mutex> guarda(trava);
+            Contadores** elo = &primeira;
+            while (*elo != contadores) {
+                elo = &(*elo)->proximo;
+            }
+            *elo = contadores->proximo;
+            encerradas.vivos += contadores->vivos.load(memory_order_relaxed);
+            encerradas.pico += picoDe(*contadores);
+            encerradas.reservados += contadores->reservados.load(memory_order_relaxed);
+            encerradas.alocacoes += contadores->alocacoes.load(memory_order_relaxed);
+            delete contadores;
         }
-        
-        tabela[indice].emplace_back(chave, valor);
-        elementos++;
+    };
+    
+    struct Acumulado {
+        long long vivos;
+        long long pico;
+        long long reservados;
+        size_t alocacoes;
+    };
+    
+    inline static mutex trava;
+    inline static Contadores* primeira = nullptr;
+    inline static Acumulado encerradas{0, 0, 0, 0};
+    alignas(64) inline static atomic<unsigned> epocaPico{0};  // reiniciarPico avança; lida a cada alocação
+    
+    static Contadores& daThread() {
+        thread_local Registro registro;
+        return *registro.contadores;
+    }
+    
+    // Só a dona escreve, então ler e gravar basta
+    template <typename T>
+    static void somar(atomic<T>& contador, T valor) {
+        contador.store(contador.load(memory_order_relaxed) + valor, memory_order_relaxed);
+    }
+    
+    static long long picoDe(const Contadores& contadores) {
+        return contadores.epocaPico.load(memory_order_relaxed) == epocaPico.load(memory_order_relaxed)
+                   ? contadores.pico.load(memory_order_relaxed)
+                   : contadores.vivos.load(memory_order_relaxed);
+    }
+    
+    static size_t tamanhoReservado(void* ponteiro, size_t bytes) {
+#if defined(__GLIBC__)
+        (void)bytes;
+        return malloc_usable_size(ponteiro) + sizeof(size_t);
+#else
+        (void)ponteiro;
+        return bytes;
+#endif
     }
     
-    bool buscar(int chave, int& valorEncontrado) {
-        size_t indice = calcularHash(chave, capacidade);
+public:
+    struct Instantaneo {
+        size_t bytesVivos;
+        size_t bytesPico;
+        size_t bytesReservados;
+        size_t alocacoes;
+    };
+    
+    // Alinhamento acima do de malloc (páginas da TabelaExtensivel) usa aligned_alloc, que
+    // pede um tamanho múltiplo do alinhamento; free e malloc_usable_size valem para os dois
+    static void* alocar(size_t bytes, size_t alinhamento = alignof(max_align_t)) {
+        void* ponteiro;
+        if (alinhamento <= alignof(max_align_t)) {
+            ponteiro = malloc(bytes > 0 ? bytes : 1);
+        } else {
+            ponteiro = aligned_alloc(alinhamento, (max(bytes, (size_t)1) + alinhamento - 1) / alinhamento * alinhamento);
+        }
+        if (ponteiro == nullptr) {
+            throw bad_alloc();
+        }
         
-        for (const auto& elem : tabela[indice]) {
-            if (elem.chave == chave) {
-                valorEncontrado = elem.valor;
-                return true;
-            }
+        Contadores& contadores = daThread();
+        // Primeira alocação depois de reiniciarPico: o pico recomeça do valor atual
+        unsigned epoca = epocaPico.load(memory_order_relaxed);
+        if (contadores.epocaPico.load(memory_order_relaxed) != epoca) {
+            contadores.pico.store(contadores.vivos.load(memory_order_relaxed), memory_order_relaxed);
+            contadores.epocaPico.store(epoca, memory_order_relaxed);
         }
-        return false;
+        somar(contadores.vivos, (long long)bytes);
+        long long atual = contadores.vivos.load(memory_order_relaxed);
+        if (atual > contadores.pico.load(memory_order_relaxed)) {
+            contadores.pico.store(atual, memory_order_relaxed);
+        }
+        somar(contadores.reservados, (long long)tamanhoReservado(ponteiro, bytes));
+        somar(contadores.alocacoes, (size_t)1);
+        return ponteiro;
     }
     
-    bool remover(int chave) {
-        size_t indice = calcularHash(chave, capacidade);
-        
-        auto it = find_if(tabela[indice].begin(), tabela[indice].end(),
-                         [chave](const Elemento& e) { return e.chave == chave; });
-        
-        if (it != tabela[indice].end()) {
-            tabela[indice].erase(it);
-            elementos--;
-            return true;
+    static void liberar(void* ponteiro, size_t bytes) {
+        Contadores& contadores = daThread();
+        somar(contadores.vivos, -(long long)bytes);
+        somar(contadores.reservados, -(long long)tamanhoReservado(ponteiro, bytes));
+        free(ponteiro);
+    }
+    
+    static Instantaneo ler() {
+        lock_guard<mutex> guarda(trava);
+        Acumulado total = encerradas;
+        for (const Contadores* contadores = primeira; contadores != nullptr; contadores = contadores->proximo) {
+            total.vivos += contadores->vivos.load(memory_order_relaxed);
+            total.pico += picoDe(*contadores);
+            total.reservados += contadores->reservados.load(memory_order_relaxed);
+            total.alocacoes += contadores->alocacoes.load(memory_order_relaxed);
         }
-        return false;
+        return {(size_t)max(total.vivos, 0LL), (size_t)max(total.pico, total.vivos),
+                (size_t)max(total.reservados, 0LL), total.alocacoes};
     }
     
-    size_t obterColisoes() const { return colisoes; }
-    size_t obterCapacidade() const { return capacidade; }
-    size_t obterElementos() const { return elementos; }
-    double obterFatorCarga() const { 
-        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    // O pico volta para o valor atual, para medir o pico de uma fase: as threads vivas
+    // recomeçam o seu na próxima alocação, e o das encerradas vira o que ficou vivo
+    static void reiniciarPico() {
+        lock_guard<mutex> guarda(trava);
+        encerradas.pico = encerradas.vivos;
+        epocaPico.fetch_add(1, memory_order_relaxed);
     }
 };
 
-// Tabela hash - REDIMENSIONAMENTO POR DUPLICAÇÃO
-class TabelaDuplicacao {
+// Alocador padrão de todas as tabelas: sem estado, conta em MedidorMemoria
+template <typename T>
+class AlocadorContado {
+public:
+    using value_type = T;
+    
+    AlocadorContado() {}
+    
+    template <typename U>
+    AlocadorContado(const AlocadorContado<U>&) {}
+    
+    T* allocate(size_t quantidade) {
+        return static_cast<T*>(MedidorMemoria::alocar(quantidade * sizeof(T), alignof(T)));
+    }
+    
+    void deallocate(T* ponteiro, size_t quantidade) {
+        MedidorMemoria::liberar(ponteiro, quantidade * sizeof(T));
+    }
+    
+    template <typename U>
+    bool operator==(const AlocadorContado<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlocadorContado<U>&) const { return false; }
+};
+
+// ALOCADOR DE NÓS EM POOL
+// Cada inserção em uma list<Elemento> aloca um nó de tamanho fixo. O pool entrega
+// esses nós a partir de placas grandes e reaproveita os liberados por uma lista livre;
+// as placas só voltam ao sistema todas juntas, quando o pool é destruído com a tabela.
+// Placas e pedidos de outro tamanho são contados em MedidorMemoria. Não é seguro para uso por várias threads ao mesmo tempo.
+class PoolNos {
 private:
-    vector<list<Elemento>> tabela;
-    size_t capacidade;
-    size_t elementos;
-    size_t colisoes;
-    size_t redimensionamentos;
-    double cargaMaxima;
-    double cargaMinima;
+    struct Livre {
+        Livre* proximo;
+    };
     
-    void redimensionar(size_t novaCapacidade) {
-        vector<list<Elemento>> tabelaAntiga = tabela;
-        
-        capacidade = novaCapacidade;
-        tabela.clear();
-        tabela.resize(capacidade);
-        elementos = 0;
-        colisoes = 0;
-        
-        for (const auto& bucket : tabelaAntiga) {
-            for (const auto& elem : bucket) {
-                size_t novoIndice = calcularHash(elem.chave, capacidade);
-                
-                if (!tabela[novoIndice].empty()) {
-                    colisoes++;
-                }
-                
-                tabela[novoIndice].emplace_back(elem.chave, elem.valor);
-                elementos++;
-            }
+    static const size_t BLOCOS_PLACA_INICIAL = 256;
+    static const size_t BLOCOS_PLACA_MAXIMO = 65536;
+    
+    vector<pair<void*, size_t>> placas;
+    Livre* livres;
+    char* cursor;
+    char* fimPlaca;
+    size_t tamanhoBloco;  // definido pela primeira alocação
+    size_t blocosProximaPlaca;
+    
+    static size_t arredondar(size_t bytes) {
+        return (bytes + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+    }
+    
+    void novaPlaca() {
+        size_t bytes = tamanhoBloco * blocosProximaPlaca;
+        cursor = static_cast<char*>(MedidorMemoria::alocar(bytes));
+        fimPlaca = cursor + bytes;
+        placas.push_back({cursor, bytes});
+        if (blocosProximaPlaca < BLOCOS_PLACA_MAXIMO) {
+            blocosProximaPlaca *= 2;
         }
-        
-        redimensionamentos++;
     }
     
 public:
-    TabelaDuplicacao(size_t capacidadeInicial = 8, double maxCarga = 0.7, double minCarga = 0.2)
-        : capacidade(capacidadeInicial), elementos(0), colisoes(0), 
-          redimensionamentos(0), cargaMaxima(maxCarga), cargaMinima(minCarga) {
-        tabela.resize(capacidadeInicial);
+    PoolNos() : livres(nullptr), cursor(nullptr), fimPlaca(nullptr), tamanhoBloco(0),
+                blocosProximaPlaca(BLOCOS_PLACA_INICIAL) {}
+    
+    PoolNos(const PoolNos&) = delete;
+    PoolNos& operator=(const PoolNos&) = delete;
+    
+    ~PoolNos() {
+        for (const auto& [placa, bytes] : placas) {
+            MedidorMemoria::liberar(placa, bytes);
+        }
     }
     
-    void inserir(int chave, int valor) {
-        if (obterFatorCarga() >= cargaMaxima) {
-            redimensionar(capacidade * 2);
+    void* alocar(size_t bytes, size_t alinhamento) {
+        if (tamanhoBloco == 0 && alinhamento <= alignof(max_align_t)) {
+            tamanhoBloco = arredondar(max(bytes, sizeof(Livre)));
         }
         
-        size_t indice = calcularHash(chave, capacidade);
-        
-        for (auto& elem : tabela[indice]) {
-            if (elem.chave == chave) {
-                elem.valor = valor;
-                return;
-            }
+        // Pedidos de outro tamanho não passam pelo pool
+        if (arredondar(max(bytes, sizeof(Livre))) != tamanhoBloco) {
+            return MedidorMemoria::alocar(bytes);
         }
         
-        if (!tabela[indice].empty()) {
-            colisoes++;
+        if (livres != nullptr) {
+            Livre* bloco = livres;
+            livres = bloco->proximo;
+            return bloco;
         }
         
-        tabela[indice].emplace_back(chave, valor);
-        elementos++;
-        
-        if (capacidade > 8 && obterFatorCarga() <= cargaMinima) {
-            redimensionar(capacidade / 2);
+        if (cursor == fimPlaca) {
+            novaPlaca();
         }
+        void* bloco = cursor;
+        cursor += tamanhoBloco;
+        return bloco;
     }
     
-    bool buscar(int chave, int& valorEncontrado) {
-        size_t indice = calcularHash(chave, capacidade);
-        
-        for (const auto& elem : tabela[indice]) {
-            if (elem.chave == chave) {
-                valorEncontrado = elem.valor;
-                return true;
-            }
+    void liberar(void* ponteiro, size_t bytes) {
+        if (arredondar(max(bytes, sizeof(Livre))) != tamanhoBloco) {
+            MedidorMemoria::liberar(ponteiro, bytes);
+            return;
         }
-        return false;
+        
+        Livre* bloco = static_cast<Livre*>(ponteiro);
+        bloco->proximo = livres;
+        livres = bloco;
     }
+};
+
+// Alocador no formato da biblioteca padrão que encaminha para um PoolNos. Sem pool
+// (construído por padrão) aloca direto, com contagem.
+template <typename T>
+class AlocadorPool {
+public:
+    using value_type = T;
     
-    bool remover(int chave) {
-        size_t indice = calcularHash(chave, capacidade);
-        
-        auto it = find_if(tabela[indice].begin(), tabela[indice].end(),
-                         [chave](const Elemento& e) { return e.chave == chave; });
-        
-        if (it != tabela[indice].end()) {
-            tabela[indice].erase(it);
-            elementos--;
-            
-            if (capacidade > 8 && obterFatorCarga() <= cargaMinima) {
-                redimensionar(capacidade / 2);
-            }
-            
-            return true;
+    PoolNos* pool;
+    
+    AlocadorPool() : pool(nullptr) {}
+    explicit AlocadorPool(PoolNos* poolNos) : pool(poolNos) {}
+    
+    template <typename U>
+    AlocadorPool(const AlocadorPool<U>& outro) : pool(outro.pool) {}
+    
+    T* allocate(size_t quantidade) {
+        if (pool == nullptr) {
+            return static_cast<T*>(MedidorMemoria::alocar(quantidade * sizeof(T)));
         }
-        return false;
+        return static_cast<T*>(pool->alocar(quantidade * sizeof(T), alignof(T)));
     }
     
-    size_t obterColisoes() const { return colisoes; }
-    size_t obterCapacidade() const { return capacidade; }
-    size_t obterElementos() const { return elementos; }
-    size_t obterRedimensionamentos() const { return redimensionamentos; }
-    double obterFatorCarga() const { 
-        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    void deallocate(T* ponteiro, size_t quantidade) {
+        if (pool == nullptr) {
+            MedidorMemoria::liberar(ponteiro, quantidade * sizeof(T));
+            return;
+        }
+        pool->liberar(ponteiro, quantidade * sizeof(T));
     }
+    
+    template <typename U>
+    bool operator==(const AlocadorPool<U>& outro) const { return pool == outro.pool; }
+    template <typename U>
+    bool operator!=(const AlocadorPool<U>& outro) const { return pool != outro.pool; }
 };
 
-// Tabela HASH - REDIMENSIONAMENTO INCREMENTAL
-class TabelaIncremental {
+// Recurso que a tabela mantém para o seu alocador: nada para alocadores sem estado,
+// um PoolNos próprio para AlocadorPool (liberado em bloco junto com a tabela)
+template <typename Alocador>
+struct RecursoAlocador {
+    struct Nenhum {};
+    using Tipo = Nenhum;
+    static Alocador criar(Tipo&) { return Alocador(); }
+};
+
+template <typename T>
+struct RecursoAlocador<AlocadorPool<T>> {
+    using Tipo = PoolNos;
+    static AlocadorPool<T> criar(PoolNos& pool) { return AlocadorPool<T>(&pool); }
+};
+
+// LINHA DO TEMPO DOS REDIMENSIONAMENTOS
+// Cada tabela anota início, fim e elementos movidos de cada redimensionamento com o
+// mesmo relógio do registrador de latência, para que um pico de latência possa ser
+// atribuído ao rehash que estava em andamento naquele instante
+long long agoraNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// bytesMovidos: bytes que o evento escreve na estrutura da tabela, isto é, vetores novos
+// preenchidos, elementos copiados e, nas encadeadas, os ponteiros de cada nó religado
+struct EventoRedimensionamento {
+    long long inicioNs;
+    long long fimNs;
+    size_t capacidadeAnterior;
+    size_t capacidadeNova;
+    size_t elementosMovidos;
+    size_t bytesMovidos;
+};
+
+// Religar um nó com splice reescreve os dois ponteiros dele e um de cada vizinho
+const size_t BYTES_RELIGAR_NO = 4 * sizeof(void*);
+
+// ESTATÍSTICAS VIVAS
+// Retrato da tabela montado só com contadores que cada inserção e remoção mantém, sem
+// percorrer a tabela: custa O(comprimento máximo) e pode ser exportado periodicamente
+// com milhões de elementos. Cadeia e sonda seguem a unidade de leitura de cada
+// estrutura: nós da lista nas encadeadas, posições na Robin Hood, janelas de controle
+// na de grupos SIMD, baldes na cuckoo e entradas da página na extensível
+struct EstatisticasTabela {
+    size_t elementos = 0;
+    size_t capacidade = 0;      // baldes (ou posições) endereçáveis
+    size_t baldesOcupados = 0;  // com pelo menos um elemento
+    size_t cadeiaMaxima = 0;
+    vector<size_t> histograma;  // histograma[c] = cadeias de comprimento c
+    double sondasAcerto = 0;    // média de uma busca que acha a chave
+    double sondasFalha = 0;     // média de uma busca por chave ausente (hash uniforme)
+};
+
+// Contagem por comprimento, atualizada em O(1) a cada cadeia que cresce ou encolhe. O
+// vetor termina no maior comprimento presente, então o máximo continua exato quando a
+// cadeia mais longa encolhe
+class HistogramaComprimentos {
 private:
-    vector<list<Elemento>> tabelaAtual;
-    vector<list<Elemento>> tabelaNova;
-    size_t capacidade;
-    size_t elementos;
-    size_t colisoes;
-    size_t redimensionamentos;
-    double cargaMaxima;
-    size_t elementosPorPasso;
-    size_t indiceAtual;
-    bool emRedimensionamento;
+    vector<size_t> contagens;
+    size_t total = 0;
     
 public:
-    TabelaIncremental(size_t capacidadeInicial = 8, double maxCarga = 0.7, size_t passo = 5)
-        : capacidade(capacidadeInicial), elementos(0), colisoes(0), 
-          redimensionamentos(0), cargaMaxima(maxCarga), elementosPorPasso(passo),
-          indiceAtual(0), emRedimensionamento(false) {
-        tabelaAtual.resize(capacidadeInicial);
+    void limpar() {
+        contagens.clear();
+        total = 0;
     }
     
-    void passoRedimensionamento() {
-        if (!emRedimensionamento || indiceAtual >= tabelaAtual.size()) return;
-        
-        size_t movidos = 0;
-        while (indiceAtual < tabelaAtual.size() && movidos < elementosPorPasso) {
-            auto& bucket = tabelaAtual[indiceAtual];
-            while (!bucket.empty() && movidos < elementosPorPasso) {
-                auto& elem = bucket.front();
-                size_t novoIndice = calcularHash(elem.chave, tabelaNova.size());
-                
-                tabelaNova[novoIndice].emplace_back(elem.chave, elem.valor);
-                bucket.pop_front();
-                movidos++;
-            }
-            
-            if (bucket.empty()) {
-                indiceAtual++;
-            }
+    void adicionar(size_t comprimento, size_t quantidade = 1) {
+        if (comprimento >= contagens.size()) {
+            contagens.resize(comprimento + 1, 0);
         }
-        
-        if (indiceAtual >= tabelaAtual.size()) {
-            tabelaAtual = move(tabelaNova);
-            capacidade = tabelaAtual.size();
-            tabelaNova.clear();
-            emRedimensionamento = false;
-            redimensionamentos++;
+        contagens[comprimento] += quantidade;
+        total += quantidade;
+    }
+    
+    void retirar(size_t comprimento, size_t quantidade = 1) {
+        contagens[comprimento] -= quantidade;
+        total -= quantidade;
+        while (!contagens.empty() && contagens.back() == 0) {
+            contagens.pop_back();
         }
     }
     
-    void inserir(int chave, int valor) {
-        if (emRedimensionamento) {
-            passoRedimensionamento();
+    // Uma cadeia passa de um comprimento a outro
+    void mudar(size_t de, size_t para) {
+        adicionar(para);
+        retirar(de);
+    }
+    
+    size_t operator[](size_t comprimento) const {
+        return comprimento < contagens.size() ? contagens[comprimento] : 0;
+    }
+    size_t obterTotal() const { return total; }
+    size_t obterMaximo() const { return contagens.empty() ? 0 : contagens.size() - 1; }
+    const vector<size_t>& obterContagens() const { return contagens; }
+};
+
+// Baldes de uma tabela encadeada por comprimento da cadeia, contados do zero
+template <typename Baldes>
+void recontarCadeias(const Baldes& tabela, HistogramaComprimentos& cadeias) {
+    cadeias.limpar();
+    for (size_t i = 0; i < tabela.size(); i++) {
+        cadeias.adicionar(tabela[i].size());
+    }
+}
+
+// Retrato de uma tabela encadeada: o i-ésimo nó de uma cadeia é achado com i sondas,
+// então o acerto custa em média Σ c(c + 1) / 2 por elemento, e uma chave ausente
+// percorre a cadeia inteira de um balde qualquer, elementos / baldes
+EstatisticasTabela estatisticasEncadeadas(const HistogramaComprimentos& cadeias, size_t elementos) {
+    EstatisticasTabela estatisticas;
+    estatisticas.elementos = elementos;
+    estatisticas.capacidade = cadeias.obterTotal();
+    estatisticas.baldesOcupados = cadeias.obterTotal() - cadeias[0];
+    estatisticas.cadeiaMaxima = cadeias.obterMaximo();
+    estatisticas.histograma = cadeias.obterContagens();
+    
+    double sondas = 0;
+    for (size_t c = 1; c < estatisticas.histograma.size(); c++) {
+        sondas += (double)c * (c + 1) / 2 * estatisticas.histograma[c];
+    }
+    estatisticas.sondasAcerto = elementos > 0 ? sondas / elementos : 0.0;
+    estatisticas.sondasFalha = estatisticas.capacidade > 0 ? (double)elementos / estatisticas.capacidade : 0.0;
+    return estatisticas;
+}
+
+// Rehash compartilhado pelas tabelas encadeadas. O vetor de baldes antigo é movido,
+// não copiado, e cada nó existente é religado no balde novo com splice, então o
+// redimensionamento não aloca nem libera nenhum elemento (num BaldeEmbutido o splice
+// move o elemento, e só os transbordos alocam). Ao dobrar uma capacidade
+// potência de 2, cada balde antigo se divide em exatamente dois baldes novos.
+// A política já deve estar ajustada para a nova capacidade; modelo é um balde vazio
+// com o alocador da tabela. As cadeias são recontadas para o novo arranjo.
+template <typename Baldes, typename PoliticaHash>
+void redistribuirBaldes(Baldes& tabela, size_t novaCapacidade, const PoliticaHash& politica,
+                        const typename Baldes::value_type& modelo, HistogramaComprimentos& cadeias) {
+    Baldes tabelaAntiga = move(tabela);
+    tabela = Baldes(novaCapacidade, modelo, tabelaAntiga.get_allocator());
+    cadeias.limpar();
+    cadeias.adicionar(0, novaCapacidade);
+    
+    for (auto& bucket : tabelaAntiga) {
+        while (!bucket.empty()) {
+            auto& destino = tabela[politica.indice(bucket.front().hash)];
+            cadeias.mudar(destino.size(), destino.size() + 1);
+            destino.splice(destino.end(), bucket, bucket.begin());
         }
+    }
+}
+
+// OPERAÇÕES EM LOTE COM PRÉ-CARGA
+// Em tabelas grandes cada busca são uma ou duas faltas de cache dependentes: o balde e
+// depois o nó. Em lote, todos os hashes são calculados e os baldes pedidos primeiro,
+// depois os primeiros nós, e só então as chaves são comparadas, então as faltas das
+// chaves do lote se sobrepõem em vez de se somarem.
+const size_t LOTE_PRECARGA = 16;
+const size_t DISTANCIA_PRECARGA = 8;  // inserções de antecedência em inserirLote
+
+inline void precarregar(const void* endereco) {
+#if defined(__GNUC__)
+    __builtin_prefetch(endereco);
+#else
+    (void)endereco;
+#endif
+}
+
+// buscarLote das tabelas encadeadas; devolve quantas chaves foram encontradas
+template <typename Baldes, typename PoliticaHash, typename Hasher, typename Igual, typename Consulta, typename Valor>
+size_t buscarLoteEncadeado(const Baldes& tabela, const PoliticaHash& politica, const Hasher& hasher,
+                           const Igual& igual, const Consulta* consultas, size_t quantidade, Valor* resultados,
+                           bool* encontrados) {
+    size_t hashes[LOTE_PRECARGA];
+    size_t indices[LOTE_PRECARGA];
+    size_t achados = 0;
+    
+    for (size_t base = 0; base < quantidade; base += LOTE_PRECARGA) {
+        size_t tamanho = min(LOTE_PRECARGA, quantidade - base);
         
-        if (!emRedimensionamento && obterFatorCarga() >= cargaMaxima) {
-            tabelaNova.resize(capacidade * 2);
-            emRedimensionamento = true;
-            indiceAtual = 0;
-            passoRedimensionamento();
+        for (size_t j = 0; j < tamanho; j++) {
+            hashes[j] = hasher(consultas[base + j]);
+            indices[j] = politica.indice(hashes[j]);
+            precarregar(&tabela[indices[j]]);
         }
-        
-        if (emRedimensionamento) {
-            size_t indice = calcularHash(chave, tabelaNova.size());
-            
-            for (auto& elem : tabelaNova[indice]) {
-                if (elem.chave == chave) {
-                    elem.valor = valor;
-                    return;
-                }
+        for (size_t j = 0; j < tamanho; j++) {
+            if (!tabela[indices[j]].empty()) {
+                precarregar(&tabela[indices[j]].front());
             }
-            
-            if (!tabelaNova[indice].empty()) {
-                colisoes++;
-            }
-            
-            tabelaNova[indice].emplace_back(chave, valor);
-        } else {
-            size_t indice = calcularHash(chave, capacidade);
-            
-            for (auto& elem : tabelaAtual[indice]) {
-                if (elem.chave == chave) {
-                    elem.valor = valor;
-                    return;
+        }
+        for (size_t j = 0; j < tamanho; j++) {
+            encontrados[base + j] = false;
+            for (const auto& elem : tabela[indices[j]]) {
+                if (elem.hash == hashes[j] && igual(elem.chave, consultas[base + j])) {
+                    resultados[base + j] = elem.valor;
+                    encontrados[base + j] = true;
+                    achados++;
+                    break;
                 }
             }
-            
-            if (!tabelaAtual[indice].empty()) {
-                colisoes++;
-            }
-            
-            tabelaAtual[indice].emplace_back(chave, valor);
         }
-        
-        elementos++;
     }
+    return achados;
+}
+
+// inserirLote de todas as tabelas: o hash de cada chave é calculado DISTANCIA_PRECARGA
+// inserções antes, quando o seu balde é pedido. Se um redimensionamento acontecer no
+// meio, as pré-cargas já feitas só erram o alvo, sem mudar o resultado
+template <typename Chave, typename Valor, typename Hasher, typename Endereco, typename Inserir>
+void inserirLoteComPrecarga(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade,
+                            const Hasher& hasher, Endereco&& enderecoBalde, Inserir&& inserirComHash) {
+    size_t hashes[DISTANCIA_PRECARGA];
     
-    bool buscar(int chave, int& valorEncontrado) {
-        if (emRedimensionamento) {
-            size_t novoIndice = calcularHash(chave, tabelaNova.size());
-            for (const auto& elem : tabelaNova[novoIndice]) {
-                if (elem.chave == chave) {
-                    valorEncontrado = elem.valor;
-                    return true;
-                }
-            }
-            
-            size_t velhoIndice = calcularHash(chave, tabelaAtual.size());
-            for (const auto& elem : tabelaAtual[velhoIndice]) {
-                if (elem.chave == chave) {
-                    valorEncontrado = elem.valor;
-                    return true;
-                }
-            }
-        } else {
-            size_t indice = calcularHash(chave, capacidade);
-            for (const auto& elem : tabelaAtual[indice]) {
-                if (elem.chave == chave) {
-                    valorEncontrado = elem.valor;
-                    return true;
-                }
-            }
-        }
-        return false;
+    for (size_t i = 0; i < min(quantidade, DISTANCIA_PRECARGA); i++) {
+        hashes[i] = hasher(chavesLote[i]);
+        precarregar(enderecoBalde(hashes[i]));
     }
-    
-    bool remover(int chave) {
-        if (emRedimensionamento) {
-            size_t novoIndice = calcularHash(chave, tabelaNova.size());
-            auto it = find_if(tabelaNova[novoIndice].begin(), tabelaNova[novoIndice].end(),
-                             [chave](const Elemento& e) { return e.chave == chave; });
-            
-            if (it != tabelaNova[novoIndice].end()) {
-                tabelaNova[novoIndice].erase(it);
-                elementos--;
-                return true;
-            }
-            
-            size_t velhoIndice = calcularHash(chave, tabelaAtual.size());
-            it = find_if(tabelaAtual[velhoIndice].begin(), tabelaAtual[velhoIndice].end(),
-                        [chave](const Elemento& e) { return e.chave == chave; });
-            
-            if (it != tabelaAtual[velhoIndice].end()) {
-                tabelaAtual[velhoIndice].erase(it);
-                elementos--;
-                return true;
-            }
-        } else {
-            size_t indice = calcularHash(chave, capacidade);
-            auto it = find_if(tabelaAtual[indice].begin(), tabelaAtual[indice].end(),
-                             [chave](const Elemento& e) { return e.chave == chave; });
-            
-            if (it != tabelaAtual[indice].end()) {
-                tabelaAtual[indice].erase(it);
-                elementos--;
-                return true;
-            }
+    for (size_t i = 0; i < quantidade; i++) {
+        size_t hash = hashes[i % DISTANCIA_PRECARGA];
+        size_t adiante = i + DISTANCIA_PRECARGA;
+        if (adiante < quantidade) {
+            hashes[adiante % DISTANCIA_PRECARGA] = hasher(chavesLote[adiante]);
+            precarregar(enderecoBalde(hashes[adiante % DISTANCIA_PRECARGA]));
         }
-        return false;
+        inserirComHash(chavesLote[i], valoresLote[i], hash);
+    }
+}
+
+// INSTRUMENTAÇÃO
+// Política de contagem das tabelas, parâmetro de template como a política de hash. A
+// SemInstrumentacao (padrão) só tem funções vazias, que somem quando expandidas: a tabela
+// compila igual a uma sem contagem nenhuma. A InstrumentacaoContada conta, por tipo de
+// operação, cálculos de hash, baldes lidos (posições na Robin Hood), elementos comparados
+// com a chave procurada, alocações e elementos movidos por rehash, estes atribuídos à
+// operação que disparou o redimensionamento
+enum class OperacaoTabela { BUSCA, INSERCAO, REMOCAO };
+
+const size_t TIPOS_OPERACAO = 3;
+
+inline const char* nomeOperacao(OperacaoTabela operacao) {
+    switch (operacao) {
+        case OperacaoTabela::BUSCA: return "BUSCA";
+        case OperacaoTabela::INSERCAO: return "INSERÇÃO";
+        default: return "REMOÇÃO";
     }
+}
+
+struct SemInstrumentacao {
+    static constexpr bool ATIVA = false;
     
-    size_t obterColisoes() const { return colisoes; }
-    size_t obterCapacidade() const { return capacidade; }
-    size_t obterElementos() const { return elementos; }
-    size_t obterRedimensionamentos() const { return redimensionamentos; }
-    double obterFatorCarga() const { 
-        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    void operacao(OperacaoTabela) {}
+    void hash(OperacaoTabela) {}
+    void baldes(OperacaoTabela, size_t) {}
+    void comparacoes(OperacaoTabela, size_t) {}
+    void alocacoes(OperacaoTabela, size_t) {}
+    void movidos(OperacaoTabela, size_t) {}
+};
+
+struct ContagemOperacao {
+    size_t operacoes = 0;
+    size_t hashes = 0;
+    size_t baldes = 0;
+    size_t comparacoes = 0;
+    size_t alocacoes = 0;
+    size_t movidos = 0;
+    
+    ContagemOperacao operator-(const ContagemOperacao& antes) const {
+        return {operacoes - antes.operacoes, hashes - antes.hashes, baldes - antes.baldes,
+                comparacoes - antes.comparacoes, alocacoes - antes.alocacoes, movidos - antes.movidos};
     }
 };
 
-// Tabela HASH - REDIMENSIONAMENTO ADAPTATIVO
-class TabelaAdaptativa {
+class InstrumentacaoContada {
 private:
-    vector<list<Elemento>> tabela;
-    size_t capacidade;
-    size_t elementos;
-    size_t colisoes;
-    size_t redimensionamentos;
-    double cargaMaxima;
-    double cargaMinima;
-    size_t limiteColisoes;
-    size_t colisoesConsecutivas;
+    ContagemOperacao contagens[TIPOS_OPERACAO];
     
-    void redimensionar(size_t novaCapacidade) {
-        vector<list<Elemento>> tabelaAntiga = tabela;
+public:
+    static constexpr bool ATIVA = true;
+    
+    void operacao(OperacaoTabela tipo) { contagens[(int)tipo].operacoes++; }
+    void hash(OperacaoTabela tipo) { contagens[(int)tipo].hashes++; }
+    void baldes(OperacaoTabela tipo, size_t quantidade) { contagens[(int)tipo].baldes += quantidade; }
+    void comparacoes(OperacaoTabela tipo, size_t quantidade) { contagens[(int)tipo].comparacoes += quantidade; }
+    void alocacoes(OperacaoTabela tipo, size_t quantidade) { contagens[(int)tipo].alocacoes += quantidade; }
+    void movidos(OperacaoTabela tipo, size_t quantidade) { contagens[(int)tipo].movidos += quantidade; }
+    
+    const ContagemOperacao& obter(OperacaoTabela tipo) const { return contagens[(int)tipo]; }
+};
+
+// CONSTRUÇÃO EM BLOCO
+// Alocadores que várias threads podem usar ao mesmo tempo; o pool de nós não pode
+template <typename Alocador>
+struct AlocadorParalelo : true_type {};
+
+template <typename T>
+struct AlocadorParalelo<AlocadorPool<T>> : false_type {};
+
+// Menor capacidade em que n elementos ficam no máximo com fator de carga carga
+inline size_t capacidadeParaCarga(size_t n, double carga) {
+    return max((size_t)1, (size_t)ceil((double)n / carga));
+}
+
+// Abaixo disso por thread, criar threads custa mais do que a construção
+const size_t MINIMO_POR_THREAD_CONSTRUCAO = 65536;
+
+// pedidas = 0 usa um por núcleo
+inline unsigned threadsConstrucao(unsigned pedidas, size_t quantidade) {
+    size_t threads = pedidas != 0 ? pedidas : max(1u, thread::hardware_concurrency());
+    return (unsigned)max((size_t)1, min(threads, quantidade / MINIMO_POR_THREAD_CONSTRUCAO));
+}
+
+// trabalho(t) para t = 0 .. threads - 1; o t = 0 roda na própria thread
+template <typename Trabalho>
+void executarEmParalelo(unsigned threads, Trabalho&& trabalho) {
+    vector<thread> auxiliares;
+    for (unsigned t = 1; t < threads; t++) {
+        auxiliares.emplace_back([&trabalho, t] { trabalho(t); });
+    }
+    trabalho(0u);
+    for (thread& auxiliar : auxiliares) {
+        auxiliar.join();
+    }
+}
+
+// Distribui pares nos baldes de uma tabela encadeada já dimensionada, sem rehash, no
+// estilo de um radix sort de um dígito: cada thread calcula os hashes do seu trecho da
+// entrada e conta quantos caem em cada faixa de baldes; as somas de prefixo dão a posição
+// de cada (faixa, thread) e cada thread espalha os índices do seu trecho; por fim cada
+// thread monta os baldes de uma faixa, que nenhuma outra toca. A ordem da entrada se
+// mantém dentro da faixa, então numa chave repetida vence a última, como em inserções
+// sucessivas. Devolve quantos elementos novos entraram; quem chama reconta as cadeias
+template <typename Baldes, typename PoliticaHash, typename Hasher, typename Igual, typename Chave, typename Valor>
+size_t construirBaldes(Baldes& tabela, const PoliticaHash& politica, const Hasher& hasher, const Igual& igual,
+                       const vector<pair<Chave, Valor>>& pares, unsigned threads) {
+    using AlocadorNo = typename Baldes::value_type::allocator_type;
+    if (!AlocadorParalelo<AlocadorNo>::value) {
+        threads = 1;
+    }
+    
+    // Uma faixa só: a partição não tem o que separar, os pares vão direto na ordem da entrada
+    auto posicionar = [&](const pair<Chave, Valor>& par, size_t hash) {
+        auto& balde = tabela[politica.indice(hash)];
+        auto it = find_if(balde.begin(), balde.end(),
+                          [&](const auto& e) { return e.hash == hash && igual(e.chave, par.first); });
+        if (it != balde.end()) {
+            it->valor = par.second;
+            return false;
+        }
+        balde.emplace_back(par.first, par.second, hash);
+        return true;
+    };
+    if (threads <= 1) {
+        size_t novos = 0;
+        for (const auto& par : pares) {
+            novos += posicionar(par, hasher(par.first));
+        }
+        return novos;
+    }
+    
+    size_t quantidade = pares.size();
+    size_t capacidade = tabela.size();
+    vector<size_t, AlocadorContado<size_t>> hashes(quantidade);
+    vector<size_t, AlocadorContado<size_t>> ordem(quantidade);
+    vector<size_t> posicoes(threads * threads, 0);  // [thread * threads + faixa]
+    vector<size_t> inicioFaixa(threads + 1, 0);
+    vector<size_t> novos(threads, 0);
+    
+    auto faixa = [&](size_t indice) { return indice * threads / capacidade; };
+    auto trecho = [&](unsigned t) { return make_pair(quantidade * t / threads, quantidade * (t + 1) / threads); };
+    
+    executarEmParalelo(threads, [&](unsigned t) {
+        auto [inicio, fim] = trecho(t);
+        for (size_t i = inicio; i < fim; i++) {
+            hashes[i] = hasher(pares[i].first);
+            posicoes[t * threads + faixa(politica.indice(hashes[i]))]++;
+        }
+    });
+    
+    size_t acumulado = 0;
+    for (unsigned f = 0; f < threads; f++) {
+        inicioFaixa[f] = acumulado;
+        for (unsigned t = 0; t < threads; t++) {
+            size_t contagem = posicoes[t * threads + f];
+            posicoes[t * threads + f] = acumulado;
+            acumulado += contagem;
+        }
+    }
+    inicioFaixa[threads] = acumulado;
+    
+    executarEmParalelo(threads, [&](unsigned t) {
+        auto [inicio, fim] = trecho(t);
+        for (size_t i = inicio; i < fim; i++) {
+            ordem[posicoes[t * threads + faixa(politica.indice(hashes[i]))]++] = i;
+        }
+    });
+    
+    executarEmParalelo(threads, [&](unsigned f) {
+        for (size_t k = inicioFaixa[f]; k < inicioFaixa[f + 1]; k++) {
+            size_t i = ordem[k];
+            novos[f] += posicionar(pares[i], hashes[i]);
+        }
+    });
+    
+    size_t total = 0;
+    for (unsigned f = 0; f < threads; f++) {
+        total += novos[f];
+    }
+    return total;
+}
+
+// FORMA DO BALDE
+// Contêiner de cada balde das tabelas encadeadas, parâmetro de template como a política de
+// hash. BaldeLista (padrão) é a list: o balde guarda só o cabeçalho da lista e cada
+// elemento é um nó alocado à parte, então todo acerto custa a falta do balde e a do nó.
+// BaldeEmbutido<K> guarda os K primeiros elementos no próprio vetor de baldes e só as
+// cadeias mais longas alocam, num vetor contíguo de transbordo: o balde fica maior (e
+// ocupa esse espaço mesmo vazio), em troca de nenhum nó e de uma falta só por acerto
+template <typename Elemento, typename Alocador, size_t K>
+class BaldePequeno {
+    static_assert(K >= 1, "BaldePequeno precisa de pelo menos um elemento embutido");
+    
+public:
+    using value_type = Elemento;
+    using allocator_type = Alocador;
+    
+    // Os embutidos e depois o transbordo: ao passar do último embutido salta para o
+    // começo do transbordo, que é o fim quando a cadeia cabe exatamente nos K
+    template <typename T>
+    class Iterador {
+    private:
+        T* atual;
+        T* fimEmbutidos;
+        T* transbordo;
         
-        capacidade = novaCapacidade;
-        tabela.clear();
-        tabela.resize(capacidade);
-        elementos = 0;
-        colisoes = 0;
-        colisoesConsecutivas = 0;
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = remove_const_t<T>;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
         
-        for (const auto& bucket : tabelaAntiga) {
-            for (const auto& elem : bucket) {
-                size_t novoIndice = calcularHash(elem.chave, capacidade);
-                
-                if (!tabela[novoIndice].empty()) {
-                    colisoes++;
-                }
-                
-                tabela[novoIndice].emplace_back(elem.chave, elem.valor);
-                elementos++;
+        Iterador() : atual(nullptr), fimEmbutidos(nullptr), transbordo(nullptr) {}
+        Iterador(T* posicao, T* fim, T* dados) : atual(posicao), fimEmbutidos(fim), transbordo(dados) {}
+        
+        T& operator*() const { return *atual; }
+        T* operator->() const { return atual; }
+        Iterador& operator++() {
+            if (++atual == fimEmbutidos) {
+                atual = transbordo;
             }
+            return *this;
         }
+        Iterador operator++(int) {
+            Iterador anterior = *this;
+            ++*this;
+            return anterior;
+        }
+        bool operator==(const Iterador& outro) const { return atual == outro.atual; }
+        bool operator!=(const Iterador& outro) const { return atual != outro.atual; }
+    };
+    
+    using iterator = Iterador<Elemento>;
+    using const_iterator = Iterador<const Elemento>;
+    
+private:
+    using Tracos = allocator_traits<Alocador>;
+    
+    // Um alocador sem estado (o contado) não ocupa espaço como base vazia
+    struct Cabecalho : Alocador {
+        Elemento* transbordo;
+        uint32_t capacidadeTransbordo;
+        uint32_t quantidade;
         
-        redimensionamentos++;
-        
-        if (colisoes > limiteColisoes * 2) {
-            cargaMaxima = max(0.5, cargaMaxima - 0.05);
-            limiteColisoes = max((size_t)10, limiteColisoes / 2);
-        } else if (colisoes < limiteColisoes / 2) {
-            cargaMaxima = min(0.9, cargaMaxima + 0.05);
-            limiteColisoes *= 2;
+        explicit Cabecalho(const Alocador& alocador)
+            : Alocador(alocador), transbordo(nullptr), capacidadeTransbordo(0), quantidade(0) {}
+    };
+    
+    Cabecalho cabecalho;
+    alignas(Elemento) unsigned char embutidos[K * sizeof(Elemento)];
+    
+    Elemento* embutido(size_t i) { return launder(reinterpret_cast<Elemento*>(embutidos) + i); }
+    const Elemento* embutido(size_t i) const { return launder(reinterpret_cast<const Elemento*>(embutidos) + i); }
+    Elemento* posicao(size_t i) { return i < K ? embutido(i) : cabecalho.transbordo + (i - K); }
+    
+    Alocador& alocador() { return cabecalho; }
+    
+    void liberarTransbordo() {
+        if (cabecalho.transbordo != nullptr) {
+            Tracos::deallocate(alocador(), cabecalho.transbordo, cabecalho.capacidadeTransbordo);
+            cabecalho.transbordo = nullptr;
+            cabecalho.capacidadeTransbordo = 0;
+        }
+    }
+    
+    void crescerTransbordo() {
+        uint32_t capacidade = cabecalho.capacidadeTransbordo == 0 ? 1 : 2 * cabecalho.capacidadeTransbordo;
+        Elemento* novo = Tracos::allocate(alocador(), capacidade);
+        for (uint32_t i = 0; i < cabecalho.quantidade - K; i++) {
+            ::new ((void*)(novo + i)) Elemento(move(cabecalho.transbordo[i]));
+            cabecalho.transbordo[i].~Elemento();
+        }
+        liberarTransbordo();
+        cabecalho.transbordo = novo;
+        cabecalho.capacidadeTransbordo = capacidade;
+    }
+    
+    void esvaziar() {
+        for (uint32_t i = 0; i < cabecalho.quantidade; i++) {
+            posicao(i)->~Elemento();
         }
+        cabecalho.quantidade = 0;
+        liberarTransbordo();
+    }
+    
+    // Os embutidos são movidos um a um; o transbordo troca de dono
+    void tomar(BaldePequeno& outro) {
+        for (uint32_t i = 0; i < min((uint32_t)K, outro.cabecalho.quantidade); i++) {
+            ::new ((void*)embutido(i)) Elemento(move(*outro.embutido(i)));
+            outro.embutido(i)->~Elemento();
+        }
+        cabecalho.transbordo = outro.cabecalho.transbordo;
+        cabecalho.capacidadeTransbordo = outro.cabecalho.capacidadeTransbordo;
+        cabecalho.quantidade = outro.cabecalho.quantidade;
+        outro.cabecalho.transbordo = nullptr;
+        outro.cabecalho.capacidadeTransbordo = 0;
+        outro.cabecalho.quantidade = 0;
     }
     
 public:
-    TabelaAdaptativa(size_t capacidadeInicial = 8, double maxCarga = 0.7, double minCarga = 0.2)
-        : capacidade(capacidadeInicial), elementos(0), colisoes(0), 
-          redimensionamentos(0), cargaMaxima(maxCarga), cargaMinima(minCarga),
-          limiteColisoes(100), colisoesConsecutivas(0) {
-        tabela.resize(capacidadeInicial);
+    explicit BaldePequeno(const Alocador& alocador = Alocador()) : cabecalho(alocador) {}
+    
+    BaldePequeno(const BaldePequeno& outro)
+        : cabecalho(Tracos::select_on_container_copy_construction(outro.cabecalho)) {
+        for (const Elemento& elemento : outro) {
+            emplace_back(elemento);
+        }
     }
     
-    void inserir(int chave, int valor) {
-        bool precisaRedimensionar = false;
-        
-        if (obterFatorCarga() >= cargaMaxima) {
-            precisaRedimensionar = true;
-        } else if (colisoes > limiteColisoes) {
-            colisoesConsecutivas++;
-            if (colisoesConsecutivas >= 3) {
-                precisaRedimensionar = true;
-                colisoesConsecutivas = 0;
+    BaldePequeno(BaldePequeno&& outro) noexcept : cabecalho(outro.cabecalho) {
+        tomar(outro);
+    }
+    
+    // Todos os baldes de uma tabela têm o mesmo alocador
+    BaldePequeno& operator=(const BaldePequeno& outro) {
+        if (this != &outro) {
+            esvaziar();
+            for (const Elemento& elemento : outro) {
+                emplace_back(elemento);
             }
-        } else {
-            colisoesConsecutivas = 0;
         }
-        
-        if (precisaRedimensionar) {
-            size_t novaCapacidade = capacidade * 2;
-            if (colisoes > limiteColisoes * 3) {
-                novaCapacidade = capacidade * 3;
-            }
-            redimensionar(novaCapacidade);
+        return *this;
+    }
+    
+    BaldePequeno& operator=(BaldePequeno&& outro) noexcept {
+        if (this != &outro) {
+            esvaziar();
+            tomar(outro);
+        }
+        return *this;
+    }
+    
+    ~BaldePequeno() { esvaziar(); }
+    
+    size_t size() const { return cabecalho.quantidade; }
+    // Elementos que cabem sem alocar: os embutidos e o transbordo atual
+    size_t capacity() const { return K + cabecalho.capacidadeTransbordo; }
+    bool empty() const { return cabecalho.quantidade == 0; }
+    allocator_type get_allocator() const { return cabecalho; }
+    
+    iterator begin() { return {embutido(0), embutido(K), cabecalho.transbordo}; }
+    iterator end() {
+        size_t n = cabecalho.quantidade;
+        return {n < K ? embutido(n) : cabecalho.transbordo + (n - K), embutido(K), cabecalho.transbordo};
+    }
+    const_iterator begin() const { return {embutido(0), embutido(K), cabecalho.transbordo}; }
+    const_iterator end() const {
+        size_t n = cabecalho.quantidade;
+        return {n < K ? embutido(n) : cabecalho.transbordo + (n - K), embutido(K), cabecalho.transbordo};
+    }
+    
+    Elemento& front() { return *embutido(0); }
+    const Elemento& front() const { return *embutido(0); }
+    
+    template <typename... Argumentos>
+    Elemento& emplace_back(Argumentos&&... argumentos) {
+        if (cabecalho.quantidade >= K && cabecalho.quantidade - K == cabecalho.capacidadeTransbordo) {
+            crescerTransbordo();
+        }
+        Elemento* destino = posicao(cabecalho.quantidade);
+        ::new ((void*)destino) Elemento(forward<Argumentos>(argumentos)...);
+        cabecalho.quantidade++;
+        return *destino;
+    }
+    
+    // O último elemento ocupa o lugar do removido: a ordem da cadeia não se mantém. Devolve
+    // o elemento que passou a ocupar a posição, ou end()
+    iterator erase(iterator alvo) {
+        Elemento* ultimo = posicao(cabecalho.quantidade - 1);
+        bool eraUltimo = &*alvo == ultimo;
+        if (!eraUltimo) {
+            *alvo = move(*ultimo);
         }
+        ultimo->~Elemento();
+        cabecalho.quantidade--;
+        // A cadeia voltou a caber nos embutidos. Um transbordo de uma posição fica: senão
+        // cada par inserção/remoção na fronteira alocaria e liberaria de novo
+        if (cabecalho.quantidade == K && cabecalho.capacidadeTransbordo > 1) {
+            liberarTransbordo();
+        }
+        // alvo ainda aponta para o transbordo de antes, que pode ter sido liberado
+        return eraUltimo ? end() : iterator(&*alvo, embutido(K), cabecalho.transbordo);
+    }
+    
+    // Mesma chamada do rehash da list; aqui o elemento é movido, não religado
+    void splice(iterator, BaldePequeno& outro, iterator elemento) {
+        emplace_back(move(*elemento));
+        outro.erase(elemento);
+    }
+};
+
+// Tipo(Elemento, Alocador) é o balde; EMBUTIDOS, quantos elementos cabem no vetor de
+// baldes; bytesMover, o que o rehash escreve por elemento; bytesElemento, o que cada
+// elemento além dos EMBUTIDOS ocupa fora do vetor de baldes, para o ControladorCusto;
+// alocaAoInserir, se mais um elemento no balde aloca, para a instrumentação
+struct BaldeLista {
+    template <typename Elemento, typename Alocador>
+    using Tipo = list<Elemento, Alocador>;
+    
+    static constexpr size_t EMBUTIDOS = 0;
+    
+    // Sempre: um nó por elemento
+    template <typename Balde>
+    static bool alocaAoInserir(const Balde&) { return true; }
+    
+    template <typename Elemento>
+    static constexpr size_t bytesMover() { return BYTES_RELIGAR_NO; }
+    // Um nó de list: o elemento e os dois ponteiros
+    template <typename Elemento>
+    static constexpr size_t bytesElemento() { return sizeof(Elemento) + 2 * sizeof(void*); }
+    static string nome() { return "LISTA"; }
+};
+
+template <size_t K>
+struct BaldeEmbutido {
+    template <typename Elemento, typename Alocador>
+    using Tipo = BaldePequeno<Elemento, Alocador, K>;
+    
+    static constexpr size_t EMBUTIDOS = K;
+    
+    // Só com os embutidos e o transbordo cheios, quando o transbordo nasce ou dobra
+    template <typename Balde>
+    static bool alocaAoInserir(const Balde& balde) { return balde.size() == balde.capacity(); }
+    
+    template <typename Elemento>
+    static constexpr size_t bytesMover() { return sizeof(Elemento); }
+    // Um elemento no transbordo; o controlador multiplica pela fração esperada deles
+    template <typename Elemento>
+    static constexpr size_t bytesElemento() { return sizeof(Elemento); }
+    static string nome() { return "EMBUTIDO K=" + to_string(K); }
+};
+
+// Tabela HASH - ESTÁTICA
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase,
+          typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao, typename FormaBalde = BaldeLista>
+class TabelaEstatica {
+private:
+    using TipoElemento = Elemento<Chave, Valor>;
+    using AlocadorElemento = typename allocator_traits<Alocador>::template rebind_alloc<TipoElemento>;
+    using Balde = typename FormaBalde::template Tipo<TipoElemento, AlocadorElemento>;
+    using Baldes = vector<Balde, typename allocator_traits<Alocador>::template rebind_alloc<Balde>>;
+    
+    // Declarados primeiro: o pool (se houver) precisa sobreviver aos baldes
+    typename RecursoAlocador<AlocadorElemento>::Tipo recurso;
+    AlocadorElemento alocador;
+    Baldes tabela;
+    size_t capacidade;
+    size_t elementos;
+    HistogramaComprimentos cadeias;  // baldes por comprimento da cadeia
+    vector<EventoRedimensionamento> eventos;  // sempre vazia: a tabela nunca redimensiona
+    PoliticaHash politica;
+    Hasher hasher;
+    Igual igual;
+    Instrumentacao instrumentacao;
+    
+public:
+    TabelaEstatica(size_t tamanhoFixo = 10007)
+        : alocador(RecursoAlocador<AlocadorElemento>::criar(recurso)),
+          capacidade(PoliticaHash::capacidadeValida(tamanhoFixo)), elementos(0) {
+        tabela.assign(capacidade, Balde(alocador));
+        cadeias.adicionar(0, capacidade);
+        politica.ajustar(capacidade);
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
         
-        size_t indice = calcularHash(chave, capacidade);
+        size_t indice = politica.indice(hash);
+        instrumentacao.baldes(OperacaoTabela::INSERCAO, 1);
         
         for (auto& elem : tabela[indice]) {
-            if (elem.chave == chave) {
-                elem.valor = valor;
+            instrumentacao.comparacoes(OperacaoTabela::INSERCAO, 1);
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                elem.valor = move(valor);
                 return;
             }
         }
         
-        if (!tabela[indice].empty()) {
-            colisoes++;
-        }
-        
-        tabela[indice].emplace_back(chave, valor);
+        cadeias.mudar(tabela[indice].size(), tabela[indice].size() + 1);
+        instrumentacao.alocacoes(OperacaoTabela::INSERCAO, FormaBalde::alocaAoInserir(tabela[indice]));
+        tabela[indice].emplace_back(move(chave), move(valor), hash);
         elementos++;
-        
-        if (capacidade > 16 && obterFatorCarga() <= cargaMinima && 
-            colisoes < limiteColisoes / 4) {
-            redimensionar(capacidade / 2);
-        }
     }
     
-    bool buscar(int chave, int& valorEncontrado) {
-        size_t indice = calcularHash(chave, capacidade);
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        
+        size_t indice = politica.indice(hash);
+        instrumentacao.baldes(OperacaoTabela::BUSCA, 1);
         
         for (const auto& elem : tabela[indice]) {
-            if (elem.chave == chave) {
+            instrumentacao.comparacoes(OperacaoTabela::BUSCA, 1);
+            if (elem.hash == hash && igual(elem.chave, chave)) {
                 valorEncontrado = elem.valor;
                 return true;
             }
@@ -485,509 +1231,7196 @@ public:
         return false;
     }
     
-    bool remover(int chave) {
-        size_t indice = calcularHash(chave, capacidade);
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        
+        size_t indice = politica.indice(hash);
+        instrumentacao.baldes(OperacaoTabela::REMOCAO, 1);
         
-        auto it = find_if(tabela[indice].begin(), tabela[indice].end(),
-                         [chave](const Elemento& e) { return e.chave == chave; });
+        auto it = find_if(tabela[indice].begin(), tabela[indice].end(), [&](const TipoElemento& e) {
+            instrumentacao.comparacoes(OperacaoTabela::REMOCAO, 1);
+            return e.hash == hash && igual(e.chave, chave);
+        });
         
         if (it != tabela[indice].end()) {
             tabela[indice].erase(it);
+            cadeias.mudar(tabela[indice].size() + 1, tabela[indice].size());
             elementos--;
-            
-            if (capacidade > 16 && obterFatorCarga() <= cargaMinima && 
-                colisoes < limiteColisoes / 4) {
-                redimensionar(capacidade / 2);
-            }
-            
             return true;
         }
         return false;
     }
     
-    size_t obterColisoes() const { return colisoes; }
+    // O tamanho é fixo por definição: reservar não faz nada
+    void reservar(size_t) {}
+    
+    // threads = 0 usa um por núcleo
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned threads = 0) {
+        elementos += construirBaldes(tabela, politica, hasher, igual, pares, threadsConstrucao(threads, pares.size()));
+        recontarCadeias(tabela, cadeias);
+    }
+    
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        return buscarLoteEncadeado(tabela, politica, hasher, igual, consultas, quantidade, resultados, encontrados);
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &tabela[politica.indice(hash)]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de balde
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        for (const auto& bucket : tabela) {
+            for (const auto& elem : bucket) {
+                visitar(elem.chave, elem.valor);
+            }
+        }
+    }
+    
+    // Colisões do arranjo atual: elementos além do primeiro de cada balde
+    size_t obterColisoes() const { return elementos - (cadeias.obterTotal() - cadeias[0]); }
+    // Sem percorrer a tabela: ver EstatisticasTabela
+    EstatisticasTabela obterEstatisticas() const { return estatisticasEncadeadas(cadeias, elementos); }
     size_t obterCapacidade() const { return capacidade; }
     size_t obterElementos() const { return elementos; }
-    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    size_t obterRedimensionamentos() const { return 0; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
     double obterFatorCarga() const { 
         return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
     }
 };
 
-// Funções auxiliares para gerar os dados
-vector<int> gerarNumerosSequenciais(int quantidade) {
-    vector<int> numeros(quantidade);
-    for (int i = 0; i < quantidade; i++) {
-        numeros[i] = i;
+// HISTERESE DO REDIMENSIONAMENTO
+// Quando a tabela por duplicação pode encolher. Crescer ao atingir cargaMaxima nunca
+// espera; encolher pela metade abaixo de cargaMinima exige também:
+// - banda: a carga depois de encolher fica pelo menos banda abaixo de cargaMaxima, então
+//   o próximo crescimento só vem depois de banda·capacidade inserções
+// - carência: depois de cada redimensionamento, carencia vezes os elementos movidos em
+//   inserções e remoções antes de encolher de novo
+// Assim cada rehash é pago por operações proporcionais ao que moveu, mesmo com
+// cargaMinima acima de cargaMaxima/2, que sem histerese alterna crescer e encolher a
+// cada par remoção/inserção na fronteira. Conta também o custo amortizado: elementos
+// rehashados por chave nova inserida
+struct HistereseRedimensionamento {
+    double banda;
+    double carencia;
+    size_t operacoesAteEncolher;
+    size_t insercoes;
+    size_t movidos;
+    
+    HistereseRedimensionamento(double faixa = 0.1, double espera = 0.5)
+        : banda(faixa), carencia(espera), operacoesAteEncolher(0), insercoes(0), movidos(0) {}
+    
+    // As regras sem histerese: encolhe sempre que a carga cai abaixo de cargaMinima
+    static HistereseRedimensionamento nenhuma() {
+        return HistereseRedimensionamento(-numeric_limits<double>::infinity(), 0);
     }
-    return numeros;
-}
-
-vector<int> gerarNumerosAleatorios(int quantidade, int maximo = 1000000) {
-    vector<int> numeros(quantidade);
-    random_device rd;
-    mt19937 gerador(rd());
-    uniform_int_distribution<> distribuicao(0, maximo);
     
-    for (int i = 0; i < quantidade; i++) {
-        numeros[i] = distribuicao(gerador);
+    // Chaves novas e remoções efetivas; atualizar um valor não conta
+    void registrarInsercoes(size_t quantidade) {
+        insercoes += quantidade;
+        descontar(quantidade);
     }
-    return numeros;
-}
-
+    void registrarRemocao() { descontar(1); }
+    
+    void registrarRedimensionamento(size_t elementosMovidos) {
+        movidos += elementosMovidos;
+        operacoesAteEncolher = (size_t)(carencia * elementosMovidos);
+    }
+    
+    bool podeEncolher(size_t elementos, size_t capacidadeNova, double cargaMaxima) const {
+        return operacoesAteEncolher == 0 && elementos <= (cargaMaxima - banda) * capacidadeNova;
+    }
+    
+    double movidosPorInsercao() const { return insercoes > 0 ? (double)movidos / insercoes : 0.0; }
+    
+private:
+    void descontar(size_t operacoes) { operacoesAteEncolher -= min(operacoesAteEncolher, operacoes); }
+};
 
-// TESTE 1: INSERÇÃO DE 1 MILHÃO DE ELEMENTOS
-void executarTeste1() {
-    cout << "=========================================================================" << endl
-    << "TESTE 1: 1 MILHÃO DE INSERÇÕES SEQUENCIAIS" << endl
-    << "=========================================================================" << endl << endl;
+// Tabela hash - REDIMENSIONAMENTO POR DUPLICAÇÃO
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase,
+          typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao, typename FormaBalde = BaldeLista>
+class TabelaDuplicacao {
+private:
+    using TipoElemento = Elemento<Chave, Valor>;
+    using AlocadorElemento = typename allocator_traits<Alocador>::template rebind_alloc<TipoElemento>;
+    using Balde = typename FormaBalde::template Tipo<TipoElemento, AlocadorElemento>;
+    using Baldes = vector<Balde, typename allocator_traits<Alocador>::template rebind_alloc<Balde>>;
+    
+    // Declarados primeiro: o pool (se houver) precisa sobreviver aos baldes
+    typename RecursoAlocador<AlocadorElemento>::Tipo recurso;
+    AlocadorElemento alocador;
+    Baldes tabela;
+    size_t capacidade;
+    size_t elementos;
+    HistogramaComprimentos cadeias;  // baldes por comprimento da cadeia
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;
+    double cargaMaxima;
+    double cargaMinima;
+    HistereseRedimensionamento histerese;
+    size_t capacidadeReservada;
+    PoliticaHash politica;
+    Hasher hasher;
+    Igual igual;
+    Instrumentacao instrumentacao;
     
-    const int TOTAL_ELEMENTOS = 1000000;
-    vector<int> dados = gerarNumerosSequenciais(TOTAL_ELEMENTOS);
+    // causa: a operação que pediu o redimensionamento (reservar conta como inserção)
+    void redimensionar(size_t novaCapacidade, OperacaoTabela causa) {
+        long long inicio = agoraNs();
+        size_t capacidadeAnterior = capacidade;
+        capacidade = PoliticaHash::capacidadeValida(novaCapacidade);
+        politica.ajustar(capacidade);
+        redistribuirBaldes(tabela, capacidade, politica, Balde(alocador), cadeias);
+        redimensionamentos++;
+        eventos.push_back({inicio, agoraNs(), capacidadeAnterior, capacidade, elementos,
+                           capacidade * sizeof(Balde) + elementos * FormaBalde::template bytesMover<TipoElemento>()});
+        histerese.registrarRedimensionamento(elementos);
+        instrumentacao.alocacoes(causa, 1);
+        instrumentacao.movidos(causa, elementos);
+    }
     
-    cout << "Tamanho da amostra: " << TOTAL_ELEMENTOS << " elementos" << endl << endl;
+    // Só depois de uma remoção: encolher depois de uma inserção desfaz o que reservar ou a
+    // capacidade inicial pediram e, com a banda estreita, alterna com o crescimento
+    void encolherSePreciso() {
+        if (capacidade > 8 && capacidade > capacidadeReservada && obterFatorCarga() <= cargaMinima &&
+            histerese.podeEncolher(elementos, capacidade / 2, cargaMaxima)) {
+            redimensionar(capacidade / 2, OperacaoTabela::REMOCAO);
+        }
+    }
     
-    vector<pair<string, void*>> estrategias = {
-        {"ESTÁTICA", new TabelaEstatica(10007)},
-        {"DUPLICAÇÃO", new TabelaDuplicacao(8, 0.7, 0.2)},
-        {"INCREMENTAL", new TabelaIncremental(8, 0.7, 5)},
-        {"ADAPTATIVA", new TabelaAdaptativa(8, 0.7, 0.2)}
-    };
+public:
+    TabelaDuplicacao(size_t capacidadeInicial = 8, double maxCarga = 0.7, double minCarga = 0.2,
+                     HistereseRedimensionamento histereseEncolher = HistereseRedimensionamento())
+        : alocador(RecursoAlocador<AlocadorElemento>::criar(recurso)),
+          capacidade(PoliticaHash::capacidadeValida(capacidadeInicial)), elementos(0), 
+          redimensionamentos(0), cargaMaxima(maxCarga), cargaMinima(minCarga), histerese(histereseEncolher),
+          capacidadeReservada(0) {
+        tabela.assign(capacidade, Balde(alocador));
+        cadeias.adicionar(0, capacidade);
+        politica.ajustar(capacidade);
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
     
-    for (auto& [nome, tabelaPtr] : estrategias) {
-        cout << "----------------------------------------" << endl
-        << "ESTRATÉGIA: " << nome << endl
-        << "----------------------------------------" << endl;
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        
+        if (obterFatorCarga() >= cargaMaxima) {
+            redimensionar(capacidade * 2, OperacaoTabela::INSERCAO);
+        }
         
-        auto inicio = chrono::high_resolution_clock::now();
+        size_t indice = politica.indice(hash);
+        instrumentacao.baldes(OperacaoTabela::INSERCAO, 1);
         
-        if (nome == "ESTÁTICA") {
-            TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
-            for (int i = 0; i < TOTAL_ELEMENTOS; i++) {
-                tabela->inserir(dados[i], dados[i] * 2);
+        for (auto& elem : tabela[indice]) {
+            instrumentacao.comparacoes(OperacaoTabela::INSERCAO, 1);
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                elem.valor = move(valor);
+                return;
             }
-            
-            auto fim = chrono::high_resolution_clock::now();
-            auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-            
-            cout << "Tempo total: " << duracao.count() << " ms" << endl;
-            cout << "Tempo por operação: " << (duracao.count() * 1000000.0) / TOTAL_ELEMENTOS << " ns" << endl;
-            cout << "Colisões: " << tabela->obterColisoes() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-            
-            size_t memoriaKB = (tabela->obterCapacidade() * 16 + TOTAL_ELEMENTOS * 12) / 1024;
-            cout << "Memória estimada: " << memoriaKB << " KB" << endl;
-            
-        } else if (nome == "DUPLICAÇÃO") {
-            TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-            for (int i = 0; i < TOTAL_ELEMENTOS; i++) {
-                tabela->inserir(dados[i], dados[i] * 2);
+        }
+        
+        cadeias.mudar(tabela[indice].size(), tabela[indice].size() + 1);
+        instrumentacao.alocacoes(OperacaoTabela::INSERCAO, FormaBalde::alocaAoInserir(tabela[indice]));
+        tabela[indice].emplace_back(move(chave), move(valor), hash);
+        elementos++;
+        histerese.registrarInsercoes(1);
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        
+        size_t indice = politica.indice(hash);
+        instrumentacao.baldes(OperacaoTabela::BUSCA, 1);
+        
+        for (const auto& elem : tabela[indice]) {
+            instrumentacao.comparacoes(OperacaoTabela::BUSCA, 1);
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                valorEncontrado = elem.valor;
+                return true;
             }
-            
-            auto fim = chrono::high_resolution_clock::now();
-            auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-            
-            cout << "Tempo total: " << duracao.count() << " ms" << endl;
-            cout << "Tempo por operação: " << (duracao.count() * 1000000.0) / TOTAL_ELEMENTOS << " ns" << endl;
-            cout << "Colisões: " << tabela->obterColisoes() << endl;
-            cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-            
-            size_t memoriaKB = (tabela->obterCapacidade() * 16 + TOTAL_ELEMENTOS * 12) / 1024;
-            cout << "Memória estimada: " << memoriaKB << " KB" << endl;
-            
-        } else if (nome == "INCREMENTAL") {
-            TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-            for (int i = 0; i < TOTAL_ELEMENTOS; i++) {
-                tabela->inserir(dados[i], dados[i] * 2);
+        }
+        return false;
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        
+        size_t indice = politica.indice(hash);
+        instrumentacao.baldes(OperacaoTabela::REMOCAO, 1);
+        
+        auto it = find_if(tabela[indice].begin(), tabela[indice].end(), [&](const TipoElemento& e) {
+            instrumentacao.comparacoes(OperacaoTabela::REMOCAO, 1);
+            return e.hash == hash && igual(e.chave, chave);
+        });
+        
+        if (it != tabela[indice].end()) {
+            tabela[indice].erase(it);
+            cadeias.mudar(tabela[indice].size() + 1, tabela[indice].size());
+            elementos--;
+            histerese.registrarRemocao();
+            encolherSePreciso();
+            return true;
+        }
+        return false;
+    }
+    
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima com no máximo um rehash; a
+    // tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        capacidadeReservada = PoliticaHash::capacidadeValida(capacidadeParaCarga(n, cargaMaxima));
+        if (capacidadeReservada > capacidade) {
+            redimensionar(capacidadeReservada, OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    // reservar para o total e distribuição direta nos baldes, sem nenhum rehash no
+    // caminho; threads = 0 usa um por núcleo
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned threads = 0) {
+        reservar(elementos + pares.size());
+        size_t novos = construirBaldes(tabela, politica, hasher, igual, pares, threadsConstrucao(threads, pares.size()));
+        elementos += novos;
+        histerese.registrarInsercoes(novos);
+        recontarCadeias(tabela, cadeias);
+    }
+    
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        return buscarLoteEncadeado(tabela, politica, hasher, igual, consultas, quantidade, resultados, encontrados);
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &tabela[politica.indice(hash)]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de balde
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        for (const auto& bucket : tabela) {
+            for (const auto& elem : bucket) {
+                visitar(elem.chave, elem.valor);
             }
-            
-            auto fim = chrono::high_resolution_clock::now();
-            auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-            
-            cout << "Tempo total: " << duracao.count() << " ms" << endl;
-            cout << "Tempo por operação: " << (duracao.count() * 1000000.0) / TOTAL_ELEMENTOS << " ns" << endl;
-            cout << "Colisões: " << tabela->obterColisoes() << endl;
-            cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-            
-            size_t memoriaKB = (tabela->obterCapacidade() * 16 + TOTAL_ELEMENTOS * 12) / 1024;
-            cout << "Memória estimada: " << memoriaKB << " KB" << endl;
-            
-        } else if (nome == "ADAPTATIVA") {
-            TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-            for (int i = 0; i < TOTAL_ELEMENTOS; i++) {
-                tabela->inserir(dados[i], dados[i] * 2);
+        }
+    }
+    
+    // Colisões do arranjo atual: elementos além do primeiro de cada balde
+    size_t obterColisoes() const { return elementos - (cadeias.obterTotal() - cadeias[0]); }
+    // Sem percorrer a tabela: ver EstatisticasTabela
+    EstatisticasTabela obterEstatisticas() const { return estatisticasEncadeadas(cadeias, elementos); }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    // Elementos rehashados (crescendo, encolhendo ou reservando) por chave nova inserida
+    double obterMovidosPorInsercao() const { return histerese.movidosPorInsercao(); }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    double obterFatorCarga() const { 
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    }
+};
+
+// Tabela HASH - REDIMENSIONAMENTO INCREMENTAL
+// Durante a migração existem duas tabelas; os baldes antigos abaixo de indiceAtual já
+// foram esvaziados, então uma chave cujo balde antigo já migrou custa uma sondagem só.
+// Cresce acima de cargaMaxima e encolhe abaixo de cargaMinima pela mesma migração.
+// A migração avança a cada inserção e remoção: cada passo move pelo menos o necessário
+// para terminar antes de a tabela nova chegar a cargaMaxima e continua enquanto couber
+// no orçamento de tempo por operação. Com migrarEmSegundoPlano ela avança numa thread
+// ajudante que esvazia a tabela antiga sem depender de novas inserções. Nesse modo cada
+// operação trava só a faixa do seu balde antigo e a do novo, sempre nessa ordem.
+// Continua sendo uma tabela de uma thread: a ajudante é a única outra. Na instrumentação,
+// cada passo conta os movidos para a operação que o pagou, e os da ajudante vão para a
+// que começou a migração
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase,
+          typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao>
+class TabelaIncremental {
+private:
+    using TipoElemento = Elemento<Chave, Valor>;
+    using AlocadorElemento = typename allocator_traits<Alocador>::template rebind_alloc<TipoElemento>;
+    using Balde = list<TipoElemento, AlocadorElemento>;
+    using Baldes = vector<Balde, typename allocator_traits<Alocador>::template rebind_alloc<Balde>>;
+    
+    static const size_t FAIXAS_TRAVA = 1024;
+    static const size_t TRABALHO_ENTRE_RELOGIOS = 8;  // baldes ou nós entre leituras do relógio
+    
+    // Declarados primeiro: o pool (se houver) precisa sobreviver aos baldes
+    typename RecursoAlocador<AlocadorElemento>::Tipo recurso;
+    AlocadorElemento alocador;
+    Baldes tabelaAtual;
+    Baldes tabelaNova;
+    size_t capacidade;
+    size_t elementos;
+    HistogramaComprimentos cadeias;  // baldes das duas tabelas por comprimento da cadeia
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;  // o último fica aberto durante a migração
+    double cargaMaxima;
+    double cargaMinima;
+    size_t capacidadeReservada;
+    long long orcamentoNs;
+    size_t restantesAntigos;  // elementos ainda na tabela antiga
+    long long custoMaximoNs;  // maior custo de migração pago por uma operação
+    atomic<size_t> indiceAtual;
+    bool emRedimensionamento;
+    PoliticaHash politicaAtual;
+    PoliticaHash politicaNova;
+    Hasher hasher;
+    Igual igual;
+    Instrumentacao instrumentacao;  // só a thread da tabela escreve
+    OperacaoTabela causaMigracao;
+    
+    // Migração em segundo plano
+    bool segundoPlano;
+    unique_ptr<mutex[]> travasAtual;
+    unique_ptr<mutex[]> travasNova;
+    atomic<size_t> movidosAjudante;
+    atomic<long long> fimAjudanteNs;
+    atomic<bool> pararAjudante;
+    thread ajudante;
+    mutable mutex travaCadeias;  // a ajudante e a operação mudam cadeias ao mesmo tempo
+    
+    // Travas de um hash durante a migração em segundo plano; o balde antigo só é travado
+    // se ainda não foi esvaziado, e a ajudante o marca como esvaziado sob a mesma trava
+    class TravaMigracao {
+    private:
+        unique_lock<mutex> antiga;
+        unique_lock<mutex> nova;
+        
+    public:
+        TravaMigracao(TabelaIncremental& tabela, size_t velhoIndice, size_t novoIndice) {
+            if (!tabela.segundoPlano) return;
+            if (velhoIndice >= tabela.indiceAtual.load(memory_order_acquire)) {
+                antiga = unique_lock<mutex>(tabela.travasAtual[velhoIndice % FAIXAS_TRAVA]);
             }
+            nova = unique_lock<mutex>(tabela.travasNova[novoIndice % FAIXAS_TRAVA]);
+        }
+    };
+    
+    // Sem a ajudante a trava nem é tomada
+    unique_lock<mutex> travarCadeias() const {
+        return segundoPlano ? unique_lock<mutex>(travaCadeias) : unique_lock<mutex>();
+    }
+    
+    void mudarCadeia(size_t de, size_t para) {
+        auto trava = travarCadeias();
+        cadeias.mudar(de, para);
+    }
+    
+    bool baldeAntigoMigrado(size_t velhoIndice) const {
+        return velhoIndice < indiceAtual.load(memory_order_acquire);
+    }
+    
+    // causa: a operação que pediu o redimensionamento
+    void iniciarMigracao(size_t novaCapacidade, OperacaoTabela causa) {
+        long long inicio = agoraNs();
+        causaMigracao = causa;
+        instrumentacao.alocacoes(causa, 1);
+        eventos.push_back({inicio, 0, capacidade, 0, 0, 0});
+        tabelaNova.assign(PoliticaHash::capacidadeValida(novaCapacidade), Balde(alocador));
+        politicaNova.ajustar(tabelaNova.size());
+        cadeias.adicionar(0, tabelaNova.size());
+        eventos.back().capacidadeNova = tabelaNova.size();
+        eventos.back().bytesMovidos = tabelaNova.size() * sizeof(Balde);
+        emRedimensionamento = true;
+        indiceAtual.store(0, memory_order_relaxed);
+        restantesAntigos = elementos;
+        
+        if (segundoPlano) {
+            movidosAjudante.store(0, memory_order_relaxed);
+            ajudante = thread([this] { migrarEmSegundoPlano(); });
+            custoMaximoNs = max(custoMaximoNs, agoraNs() - inicio);
+        } else {
+            passoRedimensionamento(inicio, causa);
+        }
+    }
+    
+    void migrarEmSegundoPlano() {
+        for (size_t i = 0; i < tabelaAtual.size() && !pararAjudante.load(memory_order_relaxed); i++) {
+            lock_guard<mutex> antiga(travasAtual[i % FAIXAS_TRAVA]);
+            auto& bucket = tabelaAtual[i];
+            size_t movidos = 0;
             
-            auto fim = chrono::high_resolution_clock::now();
-            auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-            
-            cout << "Tempo total: " << duracao.count() << " ms" << endl;
-            cout << "Tempo por operação: " << (duracao.count() * 1000000.0) / TOTAL_ELEMENTOS << " ns" << endl;
-            cout << "Colisões: " << tabela->obterColisoes() << endl;
-            cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
+            while (!bucket.empty()) {
+                size_t novoIndice = politicaNova.indice(bucket.front().hash);
+                lock_guard<mutex> nova(travasNova[novoIndice % FAIXAS_TRAVA]);
+                auto& destino = tabelaNova[novoIndice];
+                {
+                    lock_guard<mutex> trava(travaCadeias);
+                    cadeias.mudar(bucket.size(), bucket.size() - 1);
+                    cadeias.mudar(destino.size(), destino.size() + 1);
+                }
+                destino.splice(destino.end(), bucket, bucket.begin());
+                movidos++;
+            }
             
-            size_t memoriaKB = (tabela->obterCapacidade() * 16 + TOTAL_ELEMENTOS * 12) / 1024;
-            cout << "Memória estimada: " << memoriaKB << " KB" << endl;
+            movidosAjudante.fetch_add(movidos, memory_order_relaxed);
+            indiceAtual.store(i + 1, memory_order_release);
         }
-        cout << endl;
+        fimAjudanteNs.store(agoraNs(), memory_order_relaxed);
     }
     
-    for (auto& [nome, tabelaPtr] : estrategias) {
-        if (nome == "ESTÁTICA") delete static_cast<TabelaEstatica*>(tabelaPtr);
-        else if (nome == "DUPLICAÇÃO") delete static_cast<TabelaDuplicacao*>(tabelaPtr);
-        else if (nome == "INCREMENTAL") delete static_cast<TabelaIncremental*>(tabelaPtr);
-        else if (nome == "ADAPTATIVA") delete static_cast<TabelaAdaptativa*>(tabelaPtr);
+    // Troca as tabelas; no modo em segundo plano, espera a ajudante terminar
+    void concluirMigracao() {
+        if (ajudante.joinable()) {
+            ajudante.join();
+            eventos.back().elementosMovidos += movidosAjudante.load(memory_order_relaxed);
+            eventos.back().bytesMovidos += movidosAjudante.load(memory_order_relaxed) * BYTES_RELIGAR_NO;
+            instrumentacao.movidos(causaMigracao, movidosAjudante.load(memory_order_relaxed));
+            eventos.back().fimNs = fimAjudanteNs.load(memory_order_relaxed);
+        } else {
+            eventos.back().fimNs = agoraNs();
+        }
+        cadeias.retirar(0, tabelaAtual.size());  // todos já esvaziados
+        tabelaAtual = move(tabelaNova);
+        capacidade = tabelaAtual.size();
+        politicaAtual = politicaNova;
+        tabelaNova.clear();
+        emRedimensionamento = false;
+        redimensionamentos++;
+    }
+    
+    // Leva a migração em curso até o fim, de uma vez
+    void terminarMigracao(OperacaoTabela causa) {
+        if (!emRedimensionamento) return;
+        if (segundoPlano) {
+            concluirMigracao();
+        } else {
+            passoRedimensionamento(agoraNs(), causa, true);
+        }
     }
-}
-
-// TESTE 2: OPERAÇÕES MISTAS (INSERÇÃO + BUSCA)
-void executarTeste2() {
-    cout << endl << endl;
-    cout << "=========================================================================" << endl;
-    cout << "TESTE 2: 500.000 OPERAÇÕES MISTAS (50% INSERÇÃO, 50% BUSCA)" << endl;
-    cout << "=========================================================================" << endl << endl;
     
-    const int TOTAL_OPERACOES = 500000;
+    // Chamado no início de cada operação: fecha a migração que a ajudante terminou
+    void verificarAjudante() {
+        if (emRedimensionamento && segundoPlano && indiceAtual.load(memory_order_acquire) >= tabelaAtual.size()) {
+            concluirMigracao();
+        }
+    }
     
-    random_device rd;
-    mt19937 gerador(rd());
-    uniform_int_distribution<> distChaves(0, 200000);
-    uniform_real_distribution<> distOperacoes(0.0, 1.0);
+public:
+    // orcamento: nanossegundos de migração que cada inserção ou remoção pode pagar além
+    // do mínimo que garante o fim da migração a tempo
+    TabelaIncremental(size_t capacidadeInicial = 8, double maxCarga = 0.7, double minCarga = 0.2,
+                      long long orcamento = 1000, bool migrarEmSegundoPlano = false)
+        : alocador(RecursoAlocador<AlocadorElemento>::criar(recurso)),
+          capacidade(PoliticaHash::capacidadeValida(capacidadeInicial)), elementos(0), 
+          redimensionamentos(0), cargaMaxima(maxCarga), cargaMinima(minCarga), capacidadeReservada(0), orcamentoNs(orcamento),
+          restantesAntigos(0), custoMaximoNs(0), indiceAtual(0), emRedimensionamento(false),
+          causaMigracao(OperacaoTabela::INSERCAO), segundoPlano(migrarEmSegundoPlano),
+          movidosAjudante(0), fimAjudanteNs(0), pararAjudante(false) {
+        tabelaAtual.assign(capacidade, Balde(alocador));
+        cadeias.adicionar(0, capacidade);
+        politicaAtual.ajustar(capacidade);
+        if (segundoPlano) {
+            travasAtual = make_unique<mutex[]>(FAIXAS_TRAVA);
+            travasNova = make_unique<mutex[]>(FAIXAS_TRAVA);
+        }
+    }
     
-    cout << "Tamanho da amostra: " << TOTAL_OPERACOES << " operações" << endl << endl;
+    ~TabelaIncremental() {
+        if (ajudante.joinable()) {
+            pararAjudante.store(true, memory_order_relaxed);
+            ajudante.join();
+        }
+    }
     
-    vector<pair<string, void*>> estrategias = {
-        {"ESTÁTICA", new TabelaEstatica(10007)},
-        {"DUPLICAÇÃO", new TabelaDuplicacao(8, 0.7, 0.2)},
-        {"INCREMENTAL", new TabelaIncremental(8, 0.7, 5)},
-        {"ADAPTATIVA", new TabelaAdaptativa(8, 0.7, 0.2)}
-    };
+    // inicio: quando a operação começou a pagar pela migração (o custo de iniciá-la conta);
+    // causa: essa operação; tudo: termina a migração neste passo, qualquer que seja o orçamento
+    void passoRedimensionamento(long long inicio, OperacaoTabela causa, bool tudo = false) {
+        if (!emRedimensionamento || segundoPlano) return;
+        
+        // Inserções que ainda cabem antes de a tabela nova chegar a cargaMaxima; o passo
+        // move pelo menos a parte proporcional do que falta, e tudo quando não há folga
+        long long folga = (long long)(cargaMaxima * tabelaNova.size()) - (long long)elementos;
+        bool terminar = tudo || folga <= 0;
+        size_t necessarios = terminar ? restantesAntigos : (restantesAntigos + folga - 1) / folga;
+        
+        size_t indice = indiceAtual.load(memory_order_relaxed);
+        size_t movidos = 0;
+        size_t trabalho = 0;
+        while (indice < tabelaAtual.size()) {
+            auto& bucket = tabelaAtual[indice];
+            if (bucket.empty()) {
+                indice++;
+            } else {
+                size_t novoIndice = politicaNova.indice(bucket.front().hash);
+                
+                // Religa o nó na tabela nova, sem realocar o elemento
+                auto& destino = tabelaNova[novoIndice];
+                cadeias.mudar(bucket.size(), bucket.size() - 1);
+                cadeias.mudar(destino.size(), destino.size() + 1);
+                destino.splice(destino.end(), bucket, bucket.begin());
+                movidos++;
+            }
+            
+            if (!terminar && movidos >= necessarios && ++trabalho % TRABALHO_ENTRE_RELOGIOS == 0 &&
+                agoraNs() - inicio >= orcamentoNs) {
+                break;
+            }
+        }
+        indiceAtual.store(indice, memory_order_relaxed);
+        restantesAntigos -= movidos;
+        eventos.back().elementosMovidos += movidos;
+        eventos.back().bytesMovidos += movidos * BYTES_RELIGAR_NO;
+        instrumentacao.movidos(causa, movidos);
+        
+        if (indice >= tabelaAtual.size()) {
+            concluirMigracao();
+        }
+        custoMaximoNs = max(custoMaximoNs, agoraNs() - inicio);
+    }
     
-    for (auto& [nome, tabelaPtr] : estrategias) {
-        cout << "----------------------------------------" << endl
-        << "ESTRATÉGIA: " << nome << endl
-        << "----------------------------------------" << endl;
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        verificarAjudante();
+        
+        if (emRedimensionamento) {
+            passoRedimensionamento(agoraNs(), OperacaoTabela::INSERCAO);
+        }
         
-        int insercoes = 0;
-        int buscas = 0;
-        int buscasComSucesso = 0;
+        // A ajudante ficou para trás e a tabela nova já está cheia: espera ela terminar
+        if (emRedimensionamento && segundoPlano && elementos >= cargaMaxima * tabelaNova.size()) {
+            concluirMigracao();
+        }
         
-        auto inicio = chrono::high_resolution_clock::now();
+        if (!emRedimensionamento && obterFatorCarga() >= cargaMaxima) {
+            iniciarMigracao(capacidade * 2, OperacaoTabela::INSERCAO);
+        }
         
-        if (nome == "ESTÁTICA") {
-            TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
+        if (emRedimensionamento) {
+            size_t indice = politicaNova.indice(hash);
+            size_t velhoIndice = politicaAtual.indice(hash);
+            TravaMigracao trava(*this, velhoIndice, indice);
+            instrumentacao.baldes(OperacaoTabela::INSERCAO, 1);
             
-            for (int i = 0; i < 10000; i++) {
-                tabela->inserir(i, i * 2);
+            for (auto& elem : tabelaNova[indice]) {
+                instrumentacao.comparacoes(OperacaoTabela::INSERCAO, 1);
+                if (elem.hash == hash && igual(elem.chave, chave)) {
+                    elem.valor = move(valor);
+                    return;
+                }
             }
             
-            for (int i = 0; i < TOTAL_OPERACOES; i++) {
-                int chave = distChaves(gerador);
-                
-                if (distOperacoes(gerador) < 0.5) {
-                    tabela->inserir(chave, chave * 3);
-                    insercoes++;
-                } else {
-                    int valor;
-                    if (tabela->buscar(chave, valor)) {
-                        buscasComSucesso++;
+            // Chave ainda não migrada: atualiza no lugar em vez de duplicá-la na nova
+            if (!baldeAntigoMigrado(velhoIndice)) {
+                instrumentacao.baldes(OperacaoTabela::INSERCAO, 1);
+                for (auto& elem : tabelaAtual[velhoIndice]) {
+                    instrumentacao.comparacoes(OperacaoTabela::INSERCAO, 1);
+                    if (elem.hash == hash && igual(elem.chave, chave)) {
+                        elem.valor = move(valor);
+                        return;
                     }
-                    buscas++;
                 }
             }
             
-        } else if (nome == "DUPLICAÇÃO") {
-            TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-            
-            for (int i = 0; i < 10000; i++) {
-                tabela->inserir(i, i * 2);
-            }
+            mudarCadeia(tabelaNova[indice].size(), tabelaNova[indice].size() + 1);
+            tabelaNova[indice].emplace_back(move(chave), move(valor), hash);
+        } else {
+            size_t indice = politicaAtual.indice(hash);
+            instrumentacao.baldes(OperacaoTabela::INSERCAO, 1);
             
-            for (int i = 0; i < TOTAL_OPERACOES; i++) {
-                int chave = distChaves(gerador);
-                
-                if (distOperacoes(gerador) < 0.5) {
-                    tabela->inserir(chave, chave * 3);
-                    insercoes++;
-                } else {
-                    int valor;
-                    if (tabela->buscar(chave, valor)) {
-                        buscasComSucesso++;
-                    }
-                    buscas++;
+            for (auto& elem : tabelaAtual[indice]) {
+                instrumentacao.comparacoes(OperacaoTabela::INSERCAO, 1);
+                if (elem.hash == hash && igual(elem.chave, chave)) {
+                    elem.valor = move(valor);
+                    return;
                 }
             }
             
-        } else if (nome == "INCREMENTAL") {
-            TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
+            mudarCadeia(tabelaAtual[indice].size(), tabelaAtual[indice].size() + 1);
+            tabelaAtual[indice].emplace_back(move(chave), move(valor), hash);
+        }
+        
+        instrumentacao.alocacoes(OperacaoTabela::INSERCAO, 1);
+        elementos++;
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        verificarAjudante();
+        
+        if (emRedimensionamento) {
+            size_t novoIndice = politicaNova.indice(hash);
+            size_t velhoIndice = politicaAtual.indice(hash);
+            TravaMigracao trava(*this, velhoIndice, novoIndice);
+            instrumentacao.baldes(OperacaoTabela::BUSCA, 1);
             
-            for (int i = 0; i < 10000; i++) {
-                tabela->inserir(i, i * 2);
+            for (const auto& elem : tabelaNova[novoIndice]) {
+                instrumentacao.comparacoes(OperacaoTabela::BUSCA, 1);
+                if (elem.hash == hash && igual(elem.chave, chave)) {
+                    valorEncontrado = elem.valor;
+                    return true;
+                }
             }
             
-            for (int i = 0; i < TOTAL_OPERACOES; i++) {
-                int chave = distChaves(gerador);
-                
-                if (distOperacoes(gerador) < 0.5) {
-                    tabela->inserir(chave, chave * 3);
-                    insercoes++;
-                } else {
-                    int valor;
-                    if (tabela->buscar(chave, valor)) {
-                        buscasComSucesso++;
+            if (!baldeAntigoMigrado(velhoIndice)) {
+                instrumentacao.baldes(OperacaoTabela::BUSCA, 1);
+                for (const auto& elem : tabelaAtual[velhoIndice]) {
+                    instrumentacao.comparacoes(OperacaoTabela::BUSCA, 1);
+                    if (elem.hash == hash && igual(elem.chave, chave)) {
+                        valorEncontrado = elem.valor;
+                        return true;
                     }
-                    buscas++;
                 }
             }
-            
-        } else if (nome == "ADAPTATIVA") {
-            TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-            
-            for (int i = 0; i < 10000; i++) {
-                tabela->inserir(i, i * 2);
+        } else {
+            size_t indice = politicaAtual.indice(hash);
+            instrumentacao.baldes(OperacaoTabela::BUSCA, 1);
+            for (const auto& elem : tabelaAtual[indice]) {
+                instrumentacao.comparacoes(OperacaoTabela::BUSCA, 1);
+                if (elem.hash == hash && igual(elem.chave, chave)) {
+                    valorEncontrado = elem.valor;
+                    return true;
+                }
             }
+        }
+        return false;
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        verificarAjudante();
+        
+        // Um balde lido a cada busca na cadeia
+        auto procurar = [&](Balde& balde) {
+            instrumentacao.baldes(OperacaoTabela::REMOCAO, 1);
+            return find_if(balde.begin(), balde.end(), [&](const TipoElemento& e) {
+                instrumentacao.comparacoes(OperacaoTabela::REMOCAO, 1);
+                return e.hash == hash && igual(e.chave, chave);
+            });
+        };
+        
+        bool removido = false;
+        if (emRedimensionamento) {
+            size_t novoIndice = politicaNova.indice(hash);
+            size_t velhoIndice = politicaAtual.indice(hash);
+            TravaMigracao trava(*this, velhoIndice, novoIndice);
             
-            for (int i = 0; i < TOTAL_OPERACOES; i++) {
-                int chave = distChaves(gerador);
+            auto it = procurar(tabelaNova[novoIndice]);
+            
+            if (it != tabelaNova[novoIndice].end()) {
+                tabelaNova[novoIndice].erase(it);
+                mudarCadeia(tabelaNova[novoIndice].size() + 1, tabelaNova[novoIndice].size());
+                removido = true;
+            } else if (!baldeAntigoMigrado(velhoIndice)) {
+                it = procurar(tabelaAtual[velhoIndice]);
                 
-                if (distOperacoes(gerador) < 0.5) {
-                    tabela->inserir(chave, chave * 3);
-                    insercoes++;
-                } else {
-                    int valor;
-                    if (tabela->buscar(chave, valor)) {
-                        buscasComSucesso++;
-                    }
-                    buscas++;
+                if (it != tabelaAtual[velhoIndice].end()) {
+                    tabelaAtual[velhoIndice].erase(it);
+                    mudarCadeia(tabelaAtual[velhoIndice].size() + 1, tabelaAtual[velhoIndice].size());
+                    restantesAntigos--;
+                    removido = true;
                 }
             }
+        } else {
+            size_t indice = politicaAtual.indice(hash);
+            auto it = procurar(tabelaAtual[indice]);
+            
+            if (it != tabelaAtual[indice].end()) {
+                tabelaAtual[indice].erase(it);
+                mudarCadeia(tabelaAtual[indice].size() + 1, tabelaAtual[indice].size());
+                removido = true;
+            }
         }
         
-        auto fim = chrono::high_resolution_clock::now();
-        auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
+        if (!removido) {
+            return false;
+        }
+        elementos--;
         
-        cout << "Tempo total: " << duracao.count() << " ms" << endl;
-        cout << "Inserções: " << insercoes << endl;
-        cout << "Buscas: " << buscas << " (" << buscasComSucesso << " com sucesso)" << endl;
-        cout << "Taxa de sucesso: " << (buscas > 0 ? (buscasComSucesso * 100.0 / buscas) : 0) << "%" << endl;
-        cout << "Tempo por operação: " << (duracao.count() * 1000000.0) / TOTAL_OPERACOES << " ns" << endl;
+        if (emRedimensionamento) {
+            passoRedimensionamento(agoraNs(), OperacaoTabela::REMOCAO);
+        } else if (capacidade > 8 && capacidade > capacidadeReservada && obterFatorCarga() <= cargaMinima) {
+            iniciarMigracao(capacidade / 2, OperacaoTabela::REMOCAO);
+        }
+        return true;
+    }
+    
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima; termina a migração em curso e
+    // faz um único rehash completo (uma pausa escolhida por quem chama, em vez das
+    // migrações do caminho). A tabela não encolhe mais abaixo dessa capacidade
+    void reservar(size_t n) {
+        terminarMigracao(OperacaoTabela::INSERCAO);
         
-        if (nome != "ESTÁTICA") {
-            if (nome == "DUPLICAÇÃO") {
-                TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-                cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            } else if (nome == "INCREMENTAL") {
-                TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-                cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            } else if (nome == "ADAPTATIVA") {
-                TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-                cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
+        capacidadeReservada = PoliticaHash::capacidadeValida(capacidadeParaCarga(n, cargaMaxima));
+        if (capacidadeReservada > capacidade) {
+            long long inicio = agoraNs();
+            size_t capacidadeAnterior = capacidade;
+            capacidade = capacidadeReservada;
+            politicaAtual.ajustar(capacidade);
+            redistribuirBaldes(tabelaAtual, capacidade, politicaAtual, Balde(alocador), cadeias);
+            redimensionamentos++;
+            eventos.push_back({inicio, agoraNs(), capacidadeAnterior, capacidade, elementos,
+                               capacidade * sizeof(Balde) + elementos * BYTES_RELIGAR_NO});
+            instrumentacao.alocacoes(OperacaoTabela::INSERCAO, 1);
+            instrumentacao.movidos(OperacaoTabela::INSERCAO, elementos);
+        }
+    }
+    
+    // reservar para o total e distribuição direta nos baldes, sem nenhum rehash no
+    // caminho; threads = 0 usa um por núcleo
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned threads = 0) {
+        reservar(elementos + pares.size());
+        elementos += construirBaldes(tabelaAtual, politicaAtual, hasher, igual, pares,
+                                     threadsConstrucao(threads, pares.size()));
+        recontarCadeias(tabelaAtual, cadeias);
+    }
+    
+    // Durante a migração uma chave pode estar em qualquer das duas tabelas e as
+    // operações travam; o lote então recai em buscas uma a uma
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) {
+        verificarAjudante();
+        if (!emRedimensionamento) {
+            return buscarLoteEncadeado(tabelaAtual, politicaAtual, hasher, igual, consultas, quantidade, resultados,
+                                       encontrados);
+        }
+        size_t achados = 0;
+        for (size_t i = 0; i < quantidade; i++) {
+            encontrados[i] = buscar(consultas[i], resultados[i]);
+            achados += encontrados[i];
+        }
+        return achados;
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) {
+                                   return emRedimensionamento ? &tabelaNova[politicaNova.indice(hash)]
+                                                              : &tabelaAtual[politicaAtual.indice(hash)];
+                               },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento; termina antes a migração em curso para
+    // que cada elemento esteja numa tabela só (na instrumentação, por conta das buscas)
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) {
+        terminarMigracao(OperacaoTabela::BUSCA);
+        for (const auto& bucket : tabelaAtual) {
+            for (const auto& elem : bucket) {
+                visitar(elem.chave, elem.valor);
             }
         }
-        cout << endl;
     }
     
-    for (auto& [nome, tabelaPtr] : estrategias) {
-        if (nome == "ESTÁTICA") delete static_cast<TabelaEstatica*>(tabelaPtr);
-        else if (nome == "DUPLICAÇÃO") delete static_cast<TabelaDuplicacao*>(tabelaPtr);
-        else if (nome == "INCREMENTAL") delete static_cast<TabelaIncremental*>(tabelaPtr);
-        else if (nome == "ADAPTATIVA") delete static_cast<TabelaAdaptativa*>(tabelaPtr);
+    // Verdadeiro enquanto buscar e remover podem sondar as duas tabelas
+    bool estaMigrando() {
+        verificarAjudante();
+        return emRedimensionamento;
     }
-}
-
-// TESTE 3: CARGA VARIÁVEL
-void executarTeste3() {
-    cout << endl << endl
-     << "=========================================================================" << endl
-     << "TESTE 3: CARGA VARIÁVEL COM FASES DIFERENTES" << endl
-     << "=========================================================================" << endl << endl;
-    
-    cout << "Fases do teste:" << endl;
-    cout << "1) Inserção de 100.000 elementos" << endl;
-    cout << "2) Busca em 100.000 elementos" << endl;
-    cout << "3) Remoção de 50.000 e inserção de 50.000" << endl << endl;
-    
-    vector<pair<string, void*>> estrategias = {
-        {"ESTÁTICA", new TabelaEstatica(10007)},
-        {"DUPLICAÇÃO", new TabelaDuplicacao(8, 0.7, 0.2)},
-        {"INCREMENTAL", new TabelaIncremental(8, 0.7, 5)},
-        {"ADAPTATIVA", new TabelaAdaptativa(8, 0.7, 0.2)}
-    };
-    
-    for (auto& [nome, tabelaPtr] : estrategias) {
-        cout << "----------------------------------------" << endl
-        << "ESTRATÉGIA: " << nome << endl
-        << "----------------------------------------" << endl;
-        
-        auto inicioTotal = chrono::high_resolution_clock::now();
-        
-        // FASE 1: Inserção
-        cout << "FASE 1 - Inserção de 100.000 elementos:" << endl;
-        auto inicio = chrono::high_resolution_clock::now();
-        
-        if (nome == "ESTÁTICA") {
-            TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
-            for (int i = 0; i < 100000; i++) {
-                tabela->inserir(i, i * 2);
-            }
-        } else if (nome == "DUPLICAÇÃO") {
-            TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-            for (int i = 0; i < 100000; i++) {
-                tabela->inserir(i, i * 2);
-            }
-        } else if (nome == "INCREMENTAL") {
-            TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-            for (int i = 0; i < 100000; i++) {
-                tabela->inserir(i, i * 2);
-            }
-        } else if (nome == "ADAPTATIVA") {
-            TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-            for (int i = 0; i < 100000; i++) {
-                tabela->inserir(i, i * 2);
-            }
-        }
-        
-        auto fim = chrono::high_resolution_clock::now();
-        auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-        
-        if (nome == "ESTÁTICA") {
-            TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
-            cout << "  Tempo: " << duracao.count() << " ms, Colisões: " << tabela->obterColisoes() << endl;
-        } else if (nome == "DUPLICAÇÃO") {
-            TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-            cout << "  Tempo: " << duracao.count() << " ms, Colisões: " << tabela->obterColisoes() << endl;
-        } else if (nome == "INCREMENTAL") {
-            TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-            cout << "  Tempo: " << duracao.count() << " ms, Colisões: " << tabela->obterColisoes() << endl;
-        } else if (nome == "ADAPTATIVA") {
-            TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-            cout << "  Tempo: " << duracao.count() << " ms, Colisões: " << tabela->obterColisoes() << endl;
-        }
-        
-        // FASE 2: Buscas
-        cout << "FASE 2 - 100.000 buscas aleatórias:" << endl;
-        inicio = chrono::high_resolution_clock::now();
-        
-        random_device rd;
-        mt19937 gerador(rd());
-        uniform_int_distribution<> dist(0, 99999);
-        
-        int acertos = 0;
-        for (int i = 0; i < 100000; i++) {
-            int chave = dist(gerador);
-            int valor;
-            
-            if (nome == "ESTÁTICA") {
-                TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
-                if (tabela->buscar(chave, valor)) acertos++;
-            } else if (nome == "DUPLICAÇÃO") {
-                TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-                if (tabela->buscar(chave, valor)) acertos++;
-            } else if (nome == "INCREMENTAL") {
-                TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-                if (tabela->buscar(chave, valor)) acertos++;
-            } else if (nome == "ADAPTATIVA") {
-                TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-                if (tabela->buscar(chave, valor)) acertos++;
-            }
-        }
-        
-        fim = chrono::high_resolution_clock::now();
-        duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-        cout << "  Tempo: " << duracao.count() << " ms, Acertos: " << acertos << "/100000" << endl;
-        
-        // FASE 3: Remoções e novas inserções
-        cout << "FASE 3 - Remoção de 50.000 e inserção de 50.000:" << endl;
-        inicio = chrono::high_resolution_clock::now();
-        
-        if (nome == "ESTÁTICA") {
-            TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
-            for (int i = 0; i < 50000; i++) tabela->remover(i);
-            for (int i = 100000; i < 150000; i++) tabela->inserir(i, i * 3);
-        } else if (nome == "DUPLICAÇÃO") {
-            TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-            for (int i = 0; i < 50000; i++) tabela->remover(i);
-            for (int i = 100000; i < 150000; i++) tabela->inserir(i, i * 3);
-        } else if (nome == "INCREMENTAL") {
-            TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-            for (int i = 0; i < 50000; i++) tabela->remover(i);
-            for (int i = 100000; i < 150000; i++) tabela->inserir(i, i * 3);
-        } else if (nome == "ADAPTATIVA") {
-            TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-            for (int i = 0; i < 50000; i++) tabela->remover(i);
-            for (int i = 100000; i < 150000; i++) tabela->inserir(i, i * 3);
-        }
-        
-        fim = chrono::high_resolution_clock::now();
-        duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
-        cout << "  Tempo: " << duracao.count() << " ms" << endl;
-        
-        // RESULTADOS FINAIS
-        auto fimTotal = chrono::high_resolution_clock::now();
-        auto duracaoTotal = chrono::duration_cast<chrono::milliseconds>(fimTotal - inicioTotal);
-        
-        cout << endl << "RESULTADOS FINAIS:" << endl;
-        cout << "Tempo total das 3 fases: " << duracaoTotal.count() << " ms" << endl;
-        
-        if (nome == "ESTÁTICA") {
-            TabelaEstatica* tabela = static_cast<TabelaEstatica*>(tabelaPtr);
-            cout << "Colisões totais: " << tabela->obterColisoes() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-        } else if (nome == "DUPLICAÇÃO") {
-            TabelaDuplicacao* tabela = static_cast<TabelaDuplicacao*>(tabelaPtr);
-            cout << "Colisões totais: " << tabela->obterColisoes() << endl;
-            cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-        } else if (nome == "INCREMENTAL") {
-            TabelaIncremental* tabela = static_cast<TabelaIncremental*>(tabelaPtr);
-            cout << "Colisões totais: " << tabela->obterColisoes() << endl;
-            cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-        } else if (nome == "ADAPTATIVA") {
-            TabelaAdaptativa* tabela = static_cast<TabelaAdaptativa*>(tabelaPtr);
-            cout << "Colisões totais: " << tabela->obterColisoes() << endl;
-            cout << "Redimensionamentos: " << tabela->obterRedimensionamentos() << endl;
-            cout << "Fator de carga final: " << tabela->obterFatorCarga() << endl;
-        }
-        cout << endl;
-    }
-    
-    for (auto& [nome, tabelaPtr] : estrategias) {
-        if (nome == "ESTÁTICA") delete static_cast<TabelaEstatica*>(tabelaPtr);
-        else if (nome == "DUPLICAÇÃO") delete static_cast<TabelaDuplicacao*>(tabelaPtr);
-        else if (nome == "INCREMENTAL") delete static_cast<TabelaIncremental*>(tabelaPtr);
-        else if (nome == "ADAPTATIVA") delete static_cast<TabelaAdaptativa*>(tabelaPtr);
+    
+    // Colisões dos arranjos atuais: elementos além do primeiro de cada balde
+    size_t obterColisoes() const {
+        auto trava = travarCadeias();
+        return elementos - (cadeias.obterTotal() - cadeias[0]);
     }
-}
+    // Durante a migração conta os baldes das duas tabelas, como as buscas que sondam as duas
+    EstatisticasTabela obterEstatisticas() const {
+        auto trava = travarCadeias();
+        return estatisticasEncadeadas(cadeias, elementos);
+    }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    long long obterCustoMaximoMigracaoNs() const { return custoMaximoNs; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    double obterFatorCarga() const { 
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    }
+};
 
-// PROGRAMA PRINCIPAL
-int main() {
-    cout << "==================================================================" << endl
-    << "EXPERIMENTO: DIMENSIONAMENTO DINÂMICO EM TABELAS HASH" << endl
-    << "Comparação de 4 Estratégias" << endl
-    << "==================================================================" << endl << endl;
+// Tabela HASH - HASHING LINEAR (Litwin)
+// Cresce um balde por vez: quando a carga passa de cargaMaxima, o balde apontado por
+// divisao é dividido entre ele e um balde novo no fim e divisao avança; quando todos os
+// baldes do nível foram divididos, o nível dobra e divisao volta a 0. Encolhe pelo
+// caminho inverso, juntando o último balde ao seu par. Não há segundo vetor de baldes
+// nem rehash completo: cada inserção divide no máximo ⌈1 / cargaMaxima⌉ baldes e cada
+// remoção junta no máximo ⌈1 / cargaMinima⌉. Os baldes ficam em segmentos de tamanho
+// fixo, então acrescentar um balde nunca copia os demais.
+// O endereçamento exige que hash mod 2N caia em hash mod N ou hash mod N + N, o que vale
+// para o resto da divisão da referência mas não para as políticas multiplicativas; por
+// isso a tabela não recebe PoliticaHash
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao>
+class TabelaLinear {
+private:
+    using TipoElemento = Elemento<Chave, Valor>;
+    using AlocadorElemento = typename allocator_traits<Alocador>::template rebind_alloc<TipoElemento>;
+    using Balde = list<TipoElemento, AlocadorElemento>;
+    using Segmento = vector<Balde, typename allocator_traits<Alocador>::template rebind_alloc<Balde>>;
+    using Segmentos = vector<Segmento, typename allocator_traits<Alocador>::template rebind_alloc<Segmento>>;
     
-    cout << "Pressione ENTER para iniciar o Teste 1" << endl;
-    cin.get();
+    static const size_t BITS_SEGMENTO = 10;
+    static const size_t BALDES_SEGMENTO = (size_t)1 << BITS_SEGMENTO;
     
-    executarTeste1();
+    // hash mod N e, nos baldes já divididos nesta rodada (abaixo de divisao), hash mod 2N.
+    // Tem a interface de uma política para os auxiliares das tabelas encadeadas
+    struct Endereco {
+        size_t baldesNivel;  // N = capacidade inicial · 2^nível
+        size_t divisao;
+        
+        size_t indice(size_t hash) const {
+            unsigned long long completo = hashCompleto(hash);
+            size_t indice = completo % baldesNivel;
+            return indice < divisao ? completo % (2 * baldesNivel) : indice;
+        }
+    };
     
-    cout << endl << "Pressione ENTER para iniciar o Teste 2" << endl;
-    cin.get();
+    // Os segmentos vistos como um vetor de baldes, também para os auxiliares
+    template <typename Origem>
+    struct Vista {
+        using value_type = Balde;
+        Origem* segmentos;
+        size_t baldes;
+        
+        size_t size() const { return baldes; }
+        auto& operator[](size_t indice) const {
+            return (*segmentos)[indice >> BITS_SEGMENTO][indice & (BALDES_SEGMENTO - 1)];
+        }
+    };
     
-    executarTeste2();
+    // Declarados primeiro: o pool (se houver) precisa sobreviver aos baldes
+    typename RecursoAlocador<AlocadorElemento>::Tipo recurso;
+    AlocadorElemento alocador;
+    Segmentos segmentos;
+    Endereco endereco;
+    size_t capacidadeInicial;
+    size_t capacidade;  // baldes em uso: N + divisao
+    size_t elementos;
+    HistogramaComprimentos cadeias;  // baldes em uso por comprimento da cadeia
+    size_t redimensionamentos;
+    size_t divisoes;    // divisões e junções de um balde
+    size_t capacidadeReservada;
+    vector<EventoRedimensionamento> eventos;  // o último fica aberto durante a rodada
+    bool eventoAberto;
+    bool eventoCrescendo;
+    double cargaMaxima;
+    double cargaMinima;
+    Hasher hasher;
+    Igual igual;
+    Instrumentacao instrumentacao;
     
-    cout << endl << "Pressione ENTER para iniciar o Teste 3" << endl;
-    cin.get();
+    Balde& balde(size_t indice) { return Vista<Segmentos>{&segmentos, capacidade}[indice]; }
+    void adicionarSegmento() { segmentos.push_back(Segmento((size_t)BALDES_SEGMENTO, Balde(alocador))); }
+    Vista<Segmentos> vista() { return {&segmentos, capacidade}; }
+    Vista<const Segmentos> vista() const { return {&segmentos, capacidade}; }
     
-    executarTeste3();
+    // Uma rodada de divisões (ou de junções) é um evento: aberto no primeiro passo e
+    // fechado quando o nível se completa ou o sentido muda
+    void anotar(bool crescendo, size_t capacidadeAnterior, size_t capacidadeAlvo, size_t movidos, size_t bytes) {
+        divisoes++;
+        if (eventoAberto && eventoCrescendo != crescendo) {
+            fecharEvento();
+        }
+        if (!eventoAberto) {
+            eventos.push_back({agoraNs(), 0, capacidadeAnterior, capacidadeAlvo, 0, 0});
+            eventoAberto = true;
+            eventoCrescendo = crescendo;
+        }
+        eventos.back().elementosMovidos += movidos;
+        eventos.back().bytesMovidos += bytes;
+        if (endereco.divisao == 0) {
+            fecharEvento();
+        }
+    }
     
-    cout << "==================================================================" << endl
-    << "EXPERIMENTO CONCLUÍDO!" << endl
-    << "==================================================================" << endl;
+    void fecharEvento() {
+        eventos.back().fimNs = agoraNs();
+        eventos.back().capacidadeNova = capacidade;
+        eventoAberto = false;
+        redimensionamentos++;
+    }
     
-    return 0;
-}
\ No newline at end of file
+    // Divide o balde divisao entre ele e o balde novo N + divisao; causa: a operação que
+    // pediu a divisão (reservar conta como inserção)
+    void dividir(OperacaoTabela causa) {
+        size_t bytes = 0;
+        if (capacidade == segmentos.size() * BALDES_SEGMENTO) {
+            adicionarSegmento();
+            instrumentacao.alocacoes(causa, 1);
+            bytes = sizeof(Segmento) + BALDES_SEGMENTO * sizeof(Balde);
+        }
+        size_t anterior = capacidade;
+        size_t dobro = 2 * endereco.baldesNivel;
+        size_t origem = endereco.divisao;
+        size_t destino = origem + endereco.baldesNivel;
+        capacidade++;
+        
+        Balde& antigo = balde(origem);
+        Balde& novo = balde(destino);
+        size_t comprimentoAntigo = antigo.size();
+        size_t movidos = 0;
+        for (auto it = antigo.begin(); it != antigo.end();) {
+            auto elem = it++;
+            if (hashCompleto(elem->hash) % dobro == destino) {
+                novo.splice(novo.end(), antigo, elem);
+                movidos++;
+            }
+        }
+        cadeias.mudar(comprimentoAntigo, antigo.size());
+        cadeias.adicionar(novo.size());
+        
+        if (++endereco.divisao == endereco.baldesNivel) {
+            endereco.baldesNivel = dobro;
+            endereco.divisao = 0;
+        }
+        anotar(true, anterior, dobro, movidos, bytes + movidos * BYTES_RELIGAR_NO);
+        instrumentacao.movidos(causa, movidos);
+    }
+    
+    // Junta o último balde ao seu par, desfazendo a divisão mais recente
+    void juntar(OperacaoTabela causa) {
+        size_t anterior = capacidade;
+        if (endereco.divisao == 0) {
+            endereco.baldesNivel /= 2;
+            endereco.divisao = endereco.baldesNivel;
+        }
+        endereco.divisao--;
+        size_t destino = endereco.divisao;
+        size_t origem = destino + endereco.baldesNivel;
+        
+        Balde& ultimo = balde(origem);
+        Balde& par = balde(destino);
+        size_t movidos = ultimo.size();
+        cadeias.retirar(movidos);
+        cadeias.mudar(par.size(), par.size() + movidos);
+        par.splice(par.end(), ultimo);
+        capacidade--;
+        
+        // Um segmento vazio de folga fica, para não alocar e liberar na fronteira
+        if (segmentos.size() * BALDES_SEGMENTO >= capacidade + 2 * BALDES_SEGMENTO) {
+            segmentos.pop_back();
+        }
+        anotar(false, anterior, endereco.baldesNivel, movidos, movidos * BYTES_RELIGAR_NO);
+        instrumentacao.movidos(causa, movidos);
+    }
+    
+    size_t capacidadePiso() const { return max(capacidadeInicial, capacidadeReservada); }
+    
+public:
+    TabelaLinear(size_t tamanhoInicial = 8, double maxCarga = 0.7, double minCarga = 0.2)
+        : alocador(RecursoAlocador<AlocadorElemento>::criar(recurso)),
+          capacidadeInicial(max(tamanhoInicial, (size_t)1)), capacidade(capacidadeInicial), elementos(0),
+          redimensionamentos(0), divisoes(0), capacidadeReservada(0), eventoAberto(false),
+          eventoCrescendo(true), cargaMaxima(maxCarga), cargaMinima(minCarga) {
+        endereco = {capacidade, 0};
+        cadeias.adicionar(0, capacidade);
+        while (segmentos.size() * BALDES_SEGMENTO < capacidade) {
+            adicionarSegmento();
+        }
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        Balde& destino = balde(endereco.indice(hash));
+        instrumentacao.baldes(OperacaoTabela::INSERCAO, 1);
+        
+        for (auto& elem : destino) {
+            instrumentacao.comparacoes(OperacaoTabela::INSERCAO, 1);
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                elem.valor = move(valor);
+                return;
+            }
+        }
+        
+        cadeias.mudar(destino.size(), destino.size() + 1);
+        destino.emplace_back(move(chave), move(valor), hash);
+        instrumentacao.alocacoes(OperacaoTabela::INSERCAO, 1);
+        elementos++;
+        
+        while (obterFatorCarga() > cargaMaxima) {
+            dividir(OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        instrumentacao.baldes(OperacaoTabela::BUSCA, 1);
+        
+        for (const auto& elem : balde(endereco.indice(hash))) {
+            instrumentacao.comparacoes(OperacaoTabela::BUSCA, 1);
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                valorEncontrado = elem.valor;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        Balde& origem = balde(endereco.indice(hash));
+        instrumentacao.baldes(OperacaoTabela::REMOCAO, 1);
+        
+        auto it = find_if(origem.begin(), origem.end(), [&](const TipoElemento& e) {
+            instrumentacao.comparacoes(OperacaoTabela::REMOCAO, 1);
+            return e.hash == hash && igual(e.chave, chave);
+        });
+        
+        if (it == origem.end()) {
+            return false;
+        }
+        origem.erase(it);
+        elementos--;
+        cadeias.mudar(origem.size() + 1, origem.size());
+        
+        while (capacidade > capacidadePiso() && obterFatorCarga() < cargaMinima) {
+            juntar(OperacaoTabela::REMOCAO);
+        }
+        return true;
+    }
+    
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima dividindo baldes, sem vetor
+    // novo; a tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        capacidadeReservada = capacidadeParaCarga(n, cargaMaxima);
+        while (capacidade < capacidadeReservada) {
+            dividir(OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    // reservar para o total e distribuição direta nos baldes, sem nenhuma divisão no
+    // caminho; threads = 0 usa um por núcleo
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned threads = 0) {
+        reservar(elementos + pares.size());
+        auto baldes = vista();
+        elementos += construirBaldes(baldes, endereco, hasher, igual, pares, threadsConstrucao(threads, pares.size()));
+        recontarCadeias(baldes, cadeias);
+    }
+    
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        return buscarLoteEncadeado(vista(), endereco, hasher, igual, consultas, quantidade, resultados, encontrados);
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &balde(endereco.indice(hash)); },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de balde
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        auto baldes = vista();
+        for (size_t i = 0; i < capacidade; i++) {
+            for (const auto& elem : baldes[i]) {
+                visitar(elem.chave, elem.valor);
+            }
+        }
+    }
+    
+    // Colisões do arranjo atual: elementos além do primeiro de cada balde
+    size_t obterColisoes() const { return elementos - (cadeias.obterTotal() - cadeias[0]); }
+    // Sem percorrer a tabela: ver EstatisticasTabela
+    EstatisticasTabela obterEstatisticas() const { return estatisticasEncadeadas(cadeias, elementos); }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    // Rodadas concluídas: cada uma dobra ou divide por 2 o número de baldes
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    size_t obterDivisoes() const { return divisoes; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    double obterFatorCarga() const { 
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    }
+};
+
+// CONTROLADORES DE REDIMENSIONAMENTO
+// Decidem quando e para quanto a TabelaAdaptativa redimensiona e são parâmetro de template
+// dela, como a política de hash. A tabela informa cada operação (nós comparados e se a
+// chave existia) e, quando o controlador pede, o seu estado para ele decidir; a tabela
+// redimensiona para a capacidade devolvida e 0 mantém. Interface: antesDeInserir(estado),
+// registrar(operacao, achou, sondas), decidir(estado), aoRedimensionar(evento, estado),
+// aoReservar(n, estado) e obterCargaMaxima().
+
+// Fração esperada dos elementos além dos embutidos primeiros de cada cadeia, com os
+// comprimentos das cadeias em Poisson de média carga: E[max(0, X - embutidos)] / carga.
+// Com embutidos = 0 todos ficam fora; com um embutido e carga 0,7, 28%
+inline double fracaoTransbordo(size_t embutidos, double carga) {
+    if (embutidos == 0) {
+        return 1.0;
+    }
+    if (carga <= 0) {
+        return 0.0;
+    }
+    double probabilidade = exp(-carga);  // P(X = j)
+    double acumulada = 0;                // P(X <= j)
+    double dentro = 0;                   // E[min(X, embutidos)] = Σ P(X > j), j < embutidos
+    for (size_t j = 0; j < embutidos; j++) {
+        acumulada += probabilidade;
+        dentro += 1 - acumulada;
+        probabilidade *= carga / (j + 1);
+    }
+    return max(0.0, carga - dentro) / carga;
+}
+
+// O que a tabela informa ao controlador; tudo já é mantido por ela em O(1)
+struct EstadoControle {
+    size_t elementos;
+    size_t capacidade;
+    size_t colisoes;
+    size_t capacidadeReservada;  // piso de reservar; 0 = nenhum
+    size_t bytesBalde;
+    size_t bytesElemento;        // fora do vetor de baldes: o nó da lista ou a posição no transbordo
+    size_t embutidos;            // elementos de cada cadeia guardados no próprio balde
+    
+    double fatorCarga() const { return capacidade > 0 ? (double)elementos / capacidade : 0.0; }
+    
+    // Bytes fora do vetor de baldes com esses elementos nessa capacidade
+    double bytesFora(size_t novaCapacidade, double quantidade) const {
+        double carga = novaCapacidade > 0 ? quantidade / novaCapacidade : 0.0;
+        return quantidade * bytesElemento * fracaoTransbordo(embutidos, carga);
+    }
+};
+
+// As regras originais: cresce ao atingir cargaMaxima ou depois de três inserções seguidas
+// acima de limiteColisoes (triplica se passar de 3 vezes o limite) e encolhe pela metade
+// abaixo de cargaMinima com poucas colisões. Cada redimensionamento aperta ou afrouxa
+// cargaMaxima e limiteColisoes pelas colisões que sobraram no arranjo novo
+class ControladorRegras {
+private:
+    double cargaMaxima;
+    double cargaMinima;
+    size_t limiteColisoes;
+    size_t colisoesConsecutivas;
+    
+public:
+    ControladorRegras(double maxCarga = 0.7, double minCarga = 0.2)
+        : cargaMaxima(maxCarga), cargaMinima(minCarga), limiteColisoes(100), colisoesConsecutivas(0) {}
+    
+    size_t antesDeInserir(const EstadoControle& estado) {
+        bool precisaRedimensionar = false;
+        
+        if (estado.fatorCarga() >= cargaMaxima) {
+            precisaRedimensionar = true;
+        } else if (estado.colisoes > limiteColisoes) {
+            colisoesConsecutivas++;
+            if (colisoesConsecutivas >= 3) {
+                precisaRedimensionar = true;
+                colisoesConsecutivas = 0;
+            }
+        } else {
+            colisoesConsecutivas = 0;
+        }
+        
+        if (!precisaRedimensionar) {
+            return 0;
+        }
+        return estado.colisoes > limiteColisoes * 3 ? estado.capacidade * 3 : estado.capacidade * 2;
+    }
+    
+    // Só uma chave nova ou uma remoção efetiva pode encolher a tabela
+    bool registrar(OperacaoTabela operacao, bool achou, size_t) {
+        return operacao == OperacaoTabela::INSERCAO ? !achou : operacao == OperacaoTabela::REMOCAO && achou;
+    }
+    
+    size_t decidir(const EstadoControle& estado) {
+        if (estado.capacidade > 16 && estado.capacidade > estado.capacidadeReservada &&
+            estado.fatorCarga() <= cargaMinima && estado.colisoes < limiteColisoes / 4) {
+            return estado.capacidade / 2;
+        }
+        return 0;
+    }
+    
+    void aoRedimensionar(const EventoRedimensionamento&, const EstadoControle& estado) {
+        colisoesConsecutivas = 0;
+        if (estado.colisoes > limiteColisoes * 2) {
+            cargaMaxima = max(0.5, cargaMaxima - 0.05);
+            limiteColisoes = max((size_t)10, limiteColisoes / 2);
+        } else if (estado.colisoes < limiteColisoes / 2) {
+            cargaMaxima = min(0.9, cargaMaxima + 0.05);
+            limiteColisoes *= 2;
+        }
+    }
+    
+    // O gatilho por colisões parte do que um hash uniforme produz com n elementos
+    // nessa capacidade: só uma distribuição pior que a aleatória redimensiona antes
+    void aoReservar(size_t n, const EstadoControle& estado) {
+        double ocupados = estado.capacidade * (1.0 - exp(-(double)n / estado.capacidade));
+        limiteColisoes = max(limiteColisoes, (size_t)max(0.0, n - ocupados));
+    }
+    
+    double obterCargaMaxima() const { return cargaMaxima; }
+};
+
+// Escolhe a capacidade de menor custo por operação, num modelo calibrado pelo que a tabela
+// mediu nos últimos BLOCOS_JANELA blocos de OPERACOES_BLOCO operações (a janela deslizante):
+//   custo(C) = latência(C) + rehash(C) / vida(C) + pesoMemoria · bytes(C) / n
+// latência(C) é a latência observada por operação, escalada pelos nós que o fator de carga
+// de C faria comparar: 1 + kA·α num acerto, kF·α numa falha, com kA e kF medidos na janela
+// (um hash pior que o uniforme aparece neles). rehash(C) usa o custo por elemento dos
+// últimos redimensionamentos; vida(C) são as operações até C bater num trilho no ritmo
+// líquido de crescimento da janela, então numa rajada de inserções uma capacidade maior
+// dilui o rehash em mais inserções e a tabela salta mais de uma duplicação de cada vez.
+// bytes(C) são os baldes mais os nós: pesoMemoria diz quantos ns por operação vale cada
+// byte por elemento, e um orçamento, se houver, exclui as capacidades que não cabem nele.
+// Histerese: cargaMinima e cargaMaxima são só trilhos, e fora deles o redimensionamento é
+// imediato; o alvo fica sempre FOLGA para dentro dos trilhos; uma mudança voluntária
+// exige a janela inteira medida desde o último redimensionamento, ganho de MARGEM_CUSTO e
+// a mesma direção em duas decisões seguidas
+template <typename PoliticaHash = HashBase>
+class ControladorCusto {
+private:
+    static const size_t OPERACOES_BLOCO = 1024;
+    static const size_t BLOCOS_JANELA = 4;
+    static const size_t CAPACIDADE_MINIMA = 8;
+    static const int CANDIDATOS = 8;
+    static const int HORIZONTES_VIDA = 4;
+    static constexpr double FOLGA = 1.25;
+    static constexpr double MARGEM_CUSTO = 0.1;
+    static constexpr double LATENCIA_PADRAO_NS = 50;
+    
+    // Só contadores inteiros por operação; o resto é lido quando o bloco fecha
+    struct Bloco {
+        size_t operacoes = 0;
+        size_t acertos = 0;         // buscas, atualizações e remoções que acharam a chave
+        size_t sondasAcerto = 0;
+        size_t sondasFalha = 0;     // das que não acharam, e das inserções de chave nova
+        long long liquido = 0;      // chaves novas menos chaves removidas
+        double carga = 0;           // fator de carga no fim do bloco
+        long long duracaoNs = 0;    // sem o tempo gasto redimensionando
+    };
+    
+    // O que a janela diz sobre as próximas operações
+    struct Previsao {
+        double latenciaNs;
+        double sondasObservadas;
+        double fracaoAcertos;
+        double kAcerto;
+        double kFalha;
+        double horizonte;
+        double taxa;       // chaves novas menos removidas, por operação
+        double elementos;  // média entre o n atual e o projetado para o horizonte
+    };
+    
+    double cargaMaxima;
+    double cargaMinima;
+    size_t orcamentoBytes;
+    double pesoMemoria;
+    Bloco blocos[BLOCOS_JANELA];
+    size_t proximoBloco;
+    size_t blocosMedidos;
+    size_t blocosDesdeRedimensionamento;
+    Bloco atual;
+    long long inicioBlocoNs;
+    long long pausaNs;           // redimensionamentos dentro do bloco atual
+    double nsPorMovido;          // custo do rehash por elemento e balde novo
+    int direcaoPendente;         // +1 crescer, -1 encolher, 0 manter, na última decisão
+    bool removeu;                // a última operação registrada foi uma remoção efetiva
+    
+    size_t piso(const EstadoControle& estado) const {
+        return PoliticaHash::capacidadeValida(max((size_t)CAPACIDADE_MINIMA, estado.capacidadeReservada));
+    }
+    
+    // Fecha o bloco cheio e, com a janela inteira medida desde o último redimensionamento,
+    // decide; uma mudança só vale quando a decisão anterior ia na mesma direção
+    size_t fecharBloco(const EstadoControle& estado) {
+        long long agora = agoraNs();
+        atual.carga = estado.fatorCarga();
+        atual.duracaoNs = max(0LL, agora - inicioBlocoNs - pausaNs);
+        blocos[proximoBloco] = atual;
+        proximoBloco = (proximoBloco + 1) % BLOCOS_JANELA;
+        blocosMedidos = min(blocosMedidos + 1, (size_t)BLOCOS_JANELA);
+        blocosDesdeRedimensionamento++;
+        atual = Bloco();
+        inicioBlocoNs = agora;
+        pausaNs = 0;
+        
+        if (blocosDesdeRedimensionamento < BLOCOS_JANELA) {
+            return 0;
+        }
+        size_t alvo = escolher(estado, false);
+        int direcao = alvo == 0 ? 0 : alvo > estado.capacidade ? 1 : -1;
+        bool confirmada = direcao != 0 && direcao == direcaoPendente;
+        direcaoPendente = direcao;
+        return confirmada ? alvo : 0;
+    }
+    
+    // Janela medida mais o bloco em curso
+    Previsao prever(const EstadoControle& estado) const {
+        Bloco soma = atual;
+        double cargaAcerto = atual.acertos * estado.fatorCarga();  // Σ carga de cada acerto
+        double cargaFalha = (atual.operacoes - atual.acertos) * estado.fatorCarga();
+        long long duracao = 0;
+        size_t operacoesMedidas = 0;
+        for (size_t b = 0; b < blocosMedidos; b++) {
+            soma.operacoes += blocos[b].operacoes;
+            soma.acertos += blocos[b].acertos;
+            soma.sondasAcerto += blocos[b].sondasAcerto;
+            soma.sondasFalha += blocos[b].sondasFalha;
+            soma.liquido += blocos[b].liquido;
+            cargaAcerto += blocos[b].acertos * blocos[b].carga;
+            cargaFalha += (blocos[b].operacoes - blocos[b].acertos) * blocos[b].carga;
+            duracao += blocos[b].duracaoNs;
+            operacoesMedidas += blocos[b].operacoes;
+        }
+        
+        Previsao previsao;
+        previsao.latenciaNs = operacoesMedidas > 0 ? (double)duracao / operacoesMedidas : LATENCIA_PADRAO_NS;
+        previsao.fracaoAcertos = soma.operacoes > 0 ? (double)soma.acertos / soma.operacoes : 0.5;
+        // Sem medida, o encadeamento com hash uniforme: 1 + α/2 num acerto, α numa falha
+        previsao.kAcerto = cargaAcerto > 0 ? max(0.0, soma.sondasAcerto - (double)soma.acertos) / cargaAcerto : 0.5;
+        previsao.kFalha = cargaFalha > 0 ? soma.sondasFalha / cargaFalha : 1.0;
+        previsao.sondasObservadas =
+            soma.operacoes > 0 ? (double)(soma.sondasAcerto + soma.sondasFalha) / soma.operacoes
+                               : sondas(previsao, estado.fatorCarga());
+        previsao.horizonte = max((double)max(soma.operacoes, estado.elementos), 1.0);
+        
+        previsao.taxa = soma.operacoes > 0 ? (double)soma.liquido / soma.operacoes : 0.0;
+        previsao.elementos = estado.elementos + max(0.0, previsao.taxa) * previsao.horizonte / 2;
+        return previsao;
+    }
+    
+    // Operações até a capacidade bater num trilho no ritmo da janela, no máximo
+    // HORIZONTES_VIDA horizontes
+    double vida(size_t capacidade, const Previsao& previsao, const EstadoControle& estado) const {
+        double n = (double)estado.elementos;
+        double restantes = previsao.horizonte;
+        if (previsao.taxa > 0) {
+            restantes = (cargaMaxima * capacidade - n) / previsao.taxa;
+        } else if (previsao.taxa < 0) {
+            restantes = (n - cargaMinima * capacidade) / -previsao.taxa;
+        }
+        return max(1.0, min(restantes, HORIZONTES_VIDA * previsao.horizonte));
+    }
+    
+    static double sondas(const Previsao& previsao, double carga) {
+        return previsao.fracaoAcertos * (1 + previsao.kAcerto * carga) +
+               (1 - previsao.fracaoAcertos) * previsao.kFalha * carga;
+    }
+    
+    size_t bytes(size_t capacidade, const Previsao& previsao, const EstadoControle& estado) const {
+        return capacidade * estado.bytesBalde + (size_t)estado.bytesFora(capacidade, previsao.elementos);
+    }
+    
+    double custo(size_t capacidade, const Previsao& previsao, const EstadoControle& estado) const {
+        double n = max(previsao.elementos, 1.0);
+        double latencia = previsao.latenciaNs * (1 + sondas(previsao, n / capacidade)) /
+                          (1 + previsao.sondasObservadas);
+        double rehash = capacidade == estado.capacidade
+                            ? 0.0
+                            : nsPorMovido * (estado.elementos + capacidade) / vida(capacidade, previsao, estado);
+        return latencia + rehash + pesoMemoria * bytes(capacidade, previsao, estado) / n;
+    }
+    
+    // Menor custo entre as capacidades com a carga atual dentro dos trilhos com FOLGA.
+    // Forçado, devolve sempre outra capacidade; senão, só uma que ganhe MARGEM_CUSTO
+    size_t escolher(const EstadoControle& estado, bool forcado) const {
+        Previsao previsao = prever(estado);
+        size_t minima = piso(estado);
+        double cargaBaixa = cargaMinima * FOLGA;
+        double cargaAlta = cargaMaxima / FOLGA;
+        
+        size_t melhor = 0;
+        double custoMelhor = 0;
+        for (int i = 0; i <= CANDIDATOS; i++) {
+            double carga = cargaBaixa * pow(cargaAlta / cargaBaixa, (double)i / CANDIDATOS);
+            size_t capacidade = PoliticaHash::capacidadeValida(max(minima, capacidadeParaCarga(estado.elementos, carga)));
+            double cargaReal = (double)estado.elementos / capacidade;
+            bool nosTrilhos = cargaReal <= cargaAlta && (cargaReal >= cargaBaixa || capacidade == minima);
+            bool noOrcamento = orcamentoBytes == 0 || bytes(capacidade, previsao, estado) <= orcamentoBytes;
+            if (!nosTrilhos || !noOrcamento || capacidade == estado.capacidade) {
+                continue;
+            }
+            double custoCandidato = custo(capacidade, previsao, estado);
+            if (melhor == 0 || custoCandidato < custoMelhor) {
+                melhor = capacidade;
+                custoMelhor = custoCandidato;
+            }
+        }
+        
+        if (forcado) {
+            // Nenhum candidato (tabela mínima ou orçamento estourado): um passo de 2
+            if (melhor != 0) {
+                return melhor;
+            }
+            return estado.fatorCarga() >= cargaMaxima ? PoliticaHash::capacidadeValida(estado.capacidade * 2)
+                                                      : max(minima, PoliticaHash::capacidadeValida(estado.capacidade / 2));
+        }
+        if (melhor != 0 && custoMelhor < custo(estado.capacidade, previsao, estado) * (1 - MARGEM_CUSTO)) {
+            return melhor;
+        }
+        return 0;
+    }
+    
+public:
+    // orcamento = 0: sem limite de memória
+    ControladorCusto(double maxCarga = 0.7, double minCarga = 0.2, size_t orcamento = 0, double peso = 0.2)
+        : cargaMaxima(maxCarga), cargaMinima(minCarga), orcamentoBytes(orcamento), pesoMemoria(peso),
+          proximoBloco(0), blocosMedidos(0), blocosDesdeRedimensionamento(0), inicioBlocoNs(agoraNs()),
+          pausaNs(0), nsPorMovido(10), direcaoPendente(0), removeu(false) {}
+    
+    size_t antesDeInserir(const EstadoControle& estado) {
+        return estado.fatorCarga() >= cargaMaxima ? escolher(estado, true) : 0;
+    }
+    
+    // Caminho de toda operação: só contadores. O estado, o relógio e as divisões ficam
+    // para decidir, pedido no fim do bloco e depois de cada remoção efetiva
+    bool registrar(OperacaoTabela operacao, bool achou, size_t sondas) {
+        atual.operacoes++;
+        atual.acertos += achou;
+        (achou ? atual.sondasAcerto : atual.sondasFalha) += sondas;
+        
+        if (operacao == OperacaoTabela::INSERCAO) {
+            atual.liquido += !achou;
+        } else if (operacao == OperacaoTabela::REMOCAO) {
+            atual.liquido -= achou;
+            removeu = achou;
+        }
+        return removeu || atual.operacoes >= OPERACOES_BLOCO;
+    }
+    
+    size_t decidir(const EstadoControle& estado) {
+        if (removeu) {
+            removeu = false;
+            if (estado.elementos < cargaMinima * estado.capacidade && estado.capacidade > piso(estado)) {
+                return escolher(estado, true);
+            }
+        }
+        if (atual.operacoes < OPERACOES_BLOCO) {
+            return 0;
+        }
+        return fecharBloco(estado);
+    }
+    
+    void aoRedimensionar(const EventoRedimensionamento& evento, const EstadoControle&) {
+        long long duracao = evento.fimNs - evento.inicioNs;
+        double porMovido = (double)duracao / max((size_t)1, evento.elementosMovidos + evento.capacidadeNova);
+        nsPorMovido = (nsPorMovido + porMovido) / 2;
+        pausaNs += duracao;
+        blocosDesdeRedimensionamento = 0;
+        direcaoPendente = 0;
+    }
+    
+    void aoReservar(size_t, const EstadoControle&) {}
+    
+    double obterCargaMaxima() const { return cargaMaxima; }
+    double obterNsPorMovido() const { return nsPorMovido; }
+};
+
+// Tabela HASH - REDIMENSIONAMENTO ADAPTATIVO
+// Encadeada como a duplicação; quando e para quanto redimensionar fica com o Controlador
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase,
+          typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Controlador = ControladorCusto<PoliticaHash>, typename Instrumentacao = SemInstrumentacao,
+          typename FormaBalde = BaldeLista>
+class TabelaAdaptativa {
+private:
+    using TipoElemento = Elemento<Chave, Valor>;
+    using AlocadorElemento = typename allocator_traits<Alocador>::template rebind_alloc<TipoElemento>;
+    using Balde = typename FormaBalde::template Tipo<TipoElemento, AlocadorElemento>;
+    using Baldes = vector<Balde, typename allocator_traits<Alocador>::template rebind_alloc<Balde>>;
+    
+    // Declarados primeiro: o pool (se houver) precisa sobreviver aos baldes
+    typename RecursoAlocador<AlocadorElemento>::Tipo recurso;
+    AlocadorElemento alocador;
+    Baldes tabela;
+    size_t capacidade;
+    size_t elementos;
+    HistogramaComprimentos cadeias;  // baldes por comprimento da cadeia
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;
+    size_t capacidadeReservada;
+    Controlador controlador;
+    PoliticaHash politica;
+    Hasher hasher;
+    Igual igual;
+    Instrumentacao instrumentacao;
+    
+    EstadoControle estado() const {
+        return {elementos, capacidade, obterColisoes(), capacidadeReservada, sizeof(Balde),
+                FormaBalde::template bytesElemento<TipoElemento>(), FormaBalde::EMBUTIDOS};
+    }
+    
+    // causa: a operação que pediu o redimensionamento (reservar conta como inserção)
+    void redimensionar(size_t novaCapacidade, OperacaoTabela causa) {
+        long long inicio = agoraNs();
+        size_t capacidadeAnterior = capacidade;
+        capacidade = PoliticaHash::capacidadeValida(novaCapacidade);
+        politica.ajustar(capacidade);
+        redistribuirBaldes(tabela, capacidade, politica, Balde(alocador), cadeias);
+        redimensionamentos++;
+        eventos.push_back({inicio, agoraNs(), capacidadeAnterior, capacidade, elementos,
+                           capacidade * sizeof(Balde) + elementos * FormaBalde::template bytesMover<TipoElemento>()});
+        controlador.aoRedimensionar(eventos.back(), estado());
+        instrumentacao.alocacoes(causa, 1);
+        instrumentacao.movidos(causa, elementos);
+    }
+    
+    // Capacidade pedida pelo controlador; 0 mantém
+    void seguir(size_t alvo, OperacaoTabela causa) {
+        if (alvo != 0) {
+            redimensionar(alvo, causa);
+        }
+    }
+    
+    // O estado só é montado quando o controlador vai decidir
+    void informar(OperacaoTabela operacao, bool achou, size_t sondas) {
+        instrumentacao.baldes(operacao, 1);
+        instrumentacao.comparacoes(operacao, sondas);
+        if (controlador.registrar(operacao, achou, sondas)) {
+            seguir(controlador.decidir(estado()), operacao);
+        }
+    }
+    
+public:
+    TabelaAdaptativa(size_t capacidadeInicial = 8, double maxCarga = 0.7, double minCarga = 0.2)
+        : TabelaAdaptativa(capacidadeInicial, Controlador(maxCarga, minCarga)) {}
+    
+    TabelaAdaptativa(size_t capacidadeInicial, const Controlador& controle)
+        : alocador(RecursoAlocador<AlocadorElemento>::criar(recurso)),
+          capacidade(PoliticaHash::capacidadeValida(capacidadeInicial)), elementos(0), 
+          redimensionamentos(0), capacidadeReservada(0), controlador(controle) {
+        tabela.assign(capacidade, Balde(alocador));
+        cadeias.adicionar(0, capacidade);
+        politica.ajustar(capacidade);
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    // Cada operação informa ao controlador os nós comparados, que podem redimensionar a
+    // tabela depois dela; uma busca também
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        seguir(controlador.antesDeInserir(estado()), OperacaoTabela::INSERCAO);
+        
+        size_t indice = politica.indice(hash);
+        size_t sondas = 0;
+        
+        for (auto& elem : tabela[indice]) {
+            sondas++;
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                elem.valor = move(valor);
+                informar(OperacaoTabela::INSERCAO, true, sondas);
+                return;
+            }
+        }
+        
+        cadeias.mudar(tabela[indice].size(), tabela[indice].size() + 1);
+        instrumentacao.alocacoes(OperacaoTabela::INSERCAO, FormaBalde::alocaAoInserir(tabela[indice]));
+        tabela[indice].emplace_back(move(chave), move(valor), hash);
+        elementos++;
+        informar(OperacaoTabela::INSERCAO, false, sondas);
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        
+        size_t indice = politica.indice(hash);
+        size_t sondas = 0;
+        
+        for (const auto& elem : tabela[indice]) {
+            sondas++;
+            if (elem.hash == hash && igual(elem.chave, chave)) {
+                valorEncontrado = elem.valor;
+                informar(OperacaoTabela::BUSCA, true, sondas);
+                return true;
+            }
+        }
+        informar(OperacaoTabela::BUSCA, false, sondas);
+        return false;
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        
+        size_t indice = politica.indice(hash);
+        Balde& balde = tabela[indice];
+        size_t sondas = 0;
+        
+        for (auto it = balde.begin(); it != balde.end(); ++it) {
+            sondas++;
+            if (it->hash == hash && igual(it->chave, chave)) {
+                balde.erase(it);
+                cadeias.mudar(balde.size() + 1, balde.size());
+                elementos--;
+                informar(OperacaoTabela::REMOCAO, true, sondas);
+                return true;
+            }
+        }
+        informar(OperacaoTabela::REMOCAO, false, sondas);
+        return false;
+    }
+    
+    // Pré-dimensiona para n elementos abaixo da carga máxima do controlador com no máximo
+    // um rehash; a tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        capacidadeReservada = PoliticaHash::capacidadeValida(capacidadeParaCarga(n, controlador.obterCargaMaxima()));
+        if (capacidadeReservada > capacidade) {
+            redimensionar(capacidadeReservada, OperacaoTabela::INSERCAO);
+        }
+        controlador.aoReservar(n, estado());
+    }
+    
+    // reservar para o total e distribuição direta nos baldes, sem nenhum rehash no
+    // caminho; threads = 0 usa um por núcleo
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned threads = 0) {
+        reservar(elementos + pares.size());
+        elementos += construirBaldes(tabela, politica, hasher, igual, pares, threadsConstrucao(threads, pares.size()));
+        recontarCadeias(tabela, cadeias);
+    }
+    
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        return buscarLoteEncadeado(tabela, politica, hasher, igual, consultas, quantidade, resultados, encontrados);
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &tabela[politica.indice(hash)]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de balde
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        for (const auto& bucket : tabela) {
+            for (const auto& elem : bucket) {
+                visitar(elem.chave, elem.valor);
+            }
+        }
+    }
+    
+    // Colisões do arranjo atual: elementos além do primeiro de cada balde
+    size_t obterColisoes() const { return elementos - (cadeias.obterTotal() - cadeias[0]); }
+    // Sem percorrer a tabela: ver EstatisticasTabela
+    EstatisticasTabela obterEstatisticas() const { return estatisticasEncadeadas(cadeias, elementos); }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    const Controlador& obterControlador() const { return controlador; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    double obterFatorCarga() const { 
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0; 
+    }
+};
+
+// Tabela HASH - ENDEREÇAMENTO ABERTO (ROBIN HOOD)
+// Chaves e valores ficam em vetores contíguos, sem nós de lista. Sondagem linear
+// onde o elemento mais "pobre" (mais longe do balde de origem) toma o lugar do mais
+// "rico"; a remoção desloca os sucessores para trás, então não existem lápides.
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase,
+          typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao>
+class TabelaRobinHood {
+private:
+    template <typename T>
+    using Vetor = vector<T, typename allocator_traits<Alocador>::template rebind_alloc<T>>;
+
+    Vetor<Chave> chaves;
+    Vetor<Valor> valores;
+    Vetor<size_t> hashes;
+    Vetor<uint32_t> distancias;  // 0 = vazio, d + 1 = a d posições do balde de origem
+    size_t capacidade;
+    size_t elementos;
+    HistogramaComprimentos sondas;  // elementos por sondas até achá-los (distância + 1)
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;
+    double cargaMaxima;
+    double cargaMinima;
+    size_t capacidadeReservada;
+    PoliticaHash politica;
+    Hasher hasher;
+    Igual igual;
+    mutable Instrumentacao instrumentacao;  // localizar é const
+
+    size_t proximo(size_t indice) const {
+        return indice + 1 == capacidade ? 0 : indice + 1;
+    }
+
+    // Procura a posição da chave; devolve capacidade quando não existe
+    template <typename Consulta>
+    size_t localizar(const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+        size_t indice = politica.indice(hash);
+        uint32_t distancia = 1;
+        size_t comparadas = 0;
+
+        while (distancias[indice] != 0 && distancias[indice] >= distancia) {
+            comparadas += distancias[indice] == distancia;
+            if (distancias[indice] == distancia && hashes[indice] == hash && igual(chaves[indice], chave)) {
+                instrumentacao.baldes(operacao, distancia);
+                instrumentacao.comparacoes(operacao, comparadas);
+                return indice;
+            }
+            indice = proximo(indice);
+            distancia++;
+        }
+        // A posição que encerrou a sondagem também foi lida
+        instrumentacao.baldes(operacao, distancia);
+        instrumentacao.comparacoes(operacao, comparadas);
+        return capacidade;
+    }
+
+    // Insere uma chave que sabidamente não está na tabela; devolve as posições lidas
+    size_t posicionar(Chave chave, Valor valor, size_t hash) {
+        size_t indice = politica.indice(hash);
+        uint32_t distancia = 1;
+        size_t lidas = 1;
+
+        while (distancias[indice] != 0) {
+            if (distancias[indice] < distancia) {
+                sondas.mudar(distancias[indice], distancia);
+                swap(chaves[indice], chave);
+                swap(valores[indice], valor);
+                swap(hashes[indice], hash);
+                swap(distancias[indice], distancia);
+            }
+            indice = proximo(indice);
+            distancia++;
+            lidas++;
+        }
+
+        chaves[indice] = move(chave);
+        valores[indice] = move(valor);
+        hashes[indice] = hash;
+        distancias[indice] = distancia;
+        sondas.adicionar(distancia);
+        elementos++;
+        return lidas;
+    }
+
+    void alocar(size_t novaCapacidade) {
+        capacidade = PoliticaHash::capacidadeValida(novaCapacidade);
+        politica.ajustar(capacidade);
+        chaves.assign(capacidade, Chave());
+        valores.assign(capacidade, Valor());
+        hashes.assign(capacidade, 0);
+        distancias.assign(capacidade, 0);
+        sondas.limpar();
+        elementos = 0;
+    }
+
+    // causa: a operação que pediu o redimensionamento (reservar conta como inserção)
+    void redimensionar(size_t novaCapacidade, OperacaoTabela causa) {
+        long long inicio = agoraNs();
+        size_t capacidadeAnterior = capacidade;
+        Vetor<Chave> chavesAntigas = move(chaves);
+        Vetor<Valor> valoresAntigos = move(valores);
+        Vetor<size_t> hashesAntigos = move(hashes);
+        Vetor<uint32_t> distanciasAntigas = move(distancias);
+
+        alocar(novaCapacidade);
+
+        // O hash guardado evita recalcular o hash das chaves
+        for (size_t i = 0; i < distanciasAntigas.size(); i++) {
+            if (distanciasAntigas[i] != 0) {
+                posicionar(move(chavesAntigas[i]), move(valoresAntigos[i]), hashesAntigos[i]);
+            }
+        }
+
+        redimensionamentos++;
+        eventos.push_back({inicio, agoraNs(), capacidadeAnterior, capacidade, elementos,
+                           capacidade * (sizeof(Chave) + sizeof(Valor) + sizeof(size_t) + sizeof(uint32_t))});
+        instrumentacao.alocacoes(causa, 4);  // os quatro vetores
+        instrumentacao.movidos(causa, elementos);
+    }
+
+public:
+    TabelaRobinHood(size_t capacidadeInicial = 8, double maxCarga = 0.9, double minCarga = 0.2)
+        : capacidade(0), elementos(0), redimensionamentos(0),
+          cargaMaxima(maxCarga), cargaMinima(minCarga), capacidadeReservada(0) {
+        alocar(capacidadeInicial);
+    }
+
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        size_t indice = localizar(chave, hash, OperacaoTabela::INSERCAO);
+        if (indice != capacidade) {
+            valores[indice] = move(valor);
+            return;
+        }
+
+        // Endereçamento aberto não tolera fator de carga 1, por isso cresce antes
+        if ((double)(elementos + 1) / capacidade > cargaMaxima) {
+            redimensionar(capacidade * 2, OperacaoTabela::INSERCAO);
+        }
+
+        instrumentacao.baldes(OperacaoTabela::INSERCAO, posicionar(move(chave), move(valor), hash));
+    }
+
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t indice = localizar(chave, hasher(chave), OperacaoTabela::BUSCA);
+        if (indice == capacidade) {
+            return false;
+        }
+        valorEncontrado = valores[indice];
+        return true;
+    }
+
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t indice = localizar(chave, hasher(chave), OperacaoTabela::REMOCAO);
+        if (indice == capacidade) {
+            return false;
+        }
+
+        // Remoção por deslocamento para trás: puxa cada sucessor deslocado uma
+        // posição para perto do seu balde de origem até achar vazio ou distância 0
+        sondas.retirar(distancias[indice]);
+        size_t seguinte = proximo(indice);
+        while (distancias[seguinte] > 1) {
+            sondas.mudar(distancias[seguinte], distancias[seguinte] - 1);
+            chaves[indice] = move(chaves[seguinte]);
+            valores[indice] = move(valores[seguinte]);
+            hashes[indice] = hashes[seguinte];
+            distancias[indice] = distancias[seguinte] - 1;
+            indice = seguinte;
+            seguinte = proximo(seguinte);
+        }
+        distancias[indice] = 0;
+        chaves[indice] = Chave();
+        elementos--;
+
+        if (capacidade > 8 && capacidade > capacidadeReservada && obterFatorCarga() <= cargaMinima) {
+            redimensionar(capacidade / 2, OperacaoTabela::REMOCAO);
+        }
+
+        return true;
+    }
+
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima com no máximo um rehash; a
+    // tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        capacidadeReservada = PoliticaHash::capacidadeValida(capacidadeParaCarga(n, cargaMaxima));
+        if (capacidadeReservada > capacidade) {
+            redimensionar(capacidadeReservada, OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    // reservar para o total e inserções em sequência, sem nenhum rehash no caminho. Sem
+    // threads: um deslocamento pode atravessar qualquer fronteira entre faixas de posições
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned = 0) {
+        reservar(elementos + pares.size());
+        for (const auto& [chave, valor] : pares) {
+            inserir(chave, valor);
+        }
+    }
+    
+    // Pede as posições de origem do lote inteiro antes de sondar cada uma
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        size_t hashesLote[LOTE_PRECARGA];
+        size_t achados = 0;
+        
+        for (size_t base = 0; base < quantidade; base += LOTE_PRECARGA) {
+            size_t tamanho = min(LOTE_PRECARGA, quantidade - base);
+            
+            for (size_t j = 0; j < tamanho; j++) {
+                instrumentacao.operacao(OperacaoTabela::BUSCA);
+                instrumentacao.hash(OperacaoTabela::BUSCA);
+                hashesLote[j] = hasher(consultas[base + j]);
+                size_t indice = politica.indice(hashesLote[j]);
+                precarregar(&distancias[indice]);
+                precarregar(&hashes[indice]);
+                precarregar(&chaves[indice]);
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                size_t indice = localizar(consultas[base + j], hashesLote[j], OperacaoTabela::BUSCA);
+                encontrados[base + j] = indice != capacidade;
+                if (indice != capacidade) {
+                    resultados[base + j] = valores[indice];
+                    achados++;
+                }
+            }
+        }
+        return achados;
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &distancias[politica.indice(hash)]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de posição
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        for (size_t i = 0; i < capacidade; i++) {
+            if (distancias[i] != 0) {
+                visitar(chaves[i], valores[i]);
+            }
+        }
+    }
+    
+    // Elementos fora do balde de origem
+    size_t obterColisoes() const { return elementos - sondas[1]; }
+    // Cadeia de um elemento: as posições sondadas até ele. Uma busca por chave ausente
+    // que parte de h passa por todo elemento de origem até h guardado de h em diante e
+    // para na posição seguinte, então custa em média 1 + Σ sondas / capacidade
+    EstatisticasTabela obterEstatisticas() const {
+        EstatisticasTabela estatisticas;
+        estatisticas.elementos = elementos;
+        estatisticas.capacidade = capacidade;
+        estatisticas.baldesOcupados = elementos;
+        estatisticas.cadeiaMaxima = sondas.obterMaximo();
+        estatisticas.histograma = sondas.obterContagens();
+        
+        double total = 0;
+        for (size_t s = 1; s < estatisticas.histograma.size(); s++) {
+            total += (double)s * estatisticas.histograma[s];
+        }
+        estatisticas.sondasAcerto = elementos > 0 ? total / elementos : 0.0;
+        estatisticas.sondasFalha = 1.0 + total / capacidade;
+        return estatisticas;
+    }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    size_t obterDeslocamentoMaximo() const { return sondas.obterMaximo() > 0 ? sondas.obterMaximo() - 1 : 0; }
+    double obterFatorCarga() const {
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0;
+    }
+};
+
+// Tabela HASH - CUCKOO EM BALDES
+// Cada chave tem dois baldes de POSICOES_BALDE posições: o da política sobre o hash e o
+// da política sobre o hash remisturado. A busca lê no máximo esses dois baldes (e o
+// esconderijo, quase sempre vazio), então o pior caso não depende do comprimento de
+// nenhuma cadeia. Com os dois baldes cheios, a inserção procura em largura o caminho
+// de deslocamentos mais curto até uma posição livre, limitado a NOS_BUSCA baldes; sem
+// caminho, o elemento vai para o esconderijo, e só quando ele enche a tabela é refeita
+// com o dobro de baldes.
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase,
+          typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao>
+class TabelaCuckoo {
+private:
+    template <typename T>
+    using Vetor = vector<T, typename allocator_traits<Alocador>::template rebind_alloc<T>>;
+    using TipoElemento = Elemento<Chave, Valor>;
+    
+    static const size_t POSICOES_BALDE = 4;
+    static const size_t NOS_BUSCA = 512;  // 2 raízes · 4^4: caminhos de até 5 deslocamentos
+    static const size_t ESCONDERIJO_MAXIMO = 4;
+    
+    // Nó da busca em largura: o elemento da posição `posicao` do balde do nó `anterior`
+    // pode ir para `balde`; anterior = -1 nas raízes
+    struct No {
+        size_t balde;
+        int anterior;
+        unsigned posicao;
+    };
+    
+    // Hashes, chaves e valores do balde juntos: uma busca toca uma ou duas linhas de
+    // cache por balde em vez de uma por vetor
+    struct Balde {
+        uint8_t ocupadas;  // bit p = posição p ocupada
+        size_t hashes[POSICOES_BALDE];
+        Chave chaves[POSICOES_BALDE];
+        Valor valores[POSICOES_BALDE];
+    };
+    
+    Vetor<Balde> tabela;
+    Vetor<TipoElemento> esconderijo;
+    size_t baldes;
+    size_t capacidade;        // posições
+    size_t elementos;
+    HistogramaComprimentos ocupacao;  // baldes por posições ocupadas
+    size_t secundarios;               // elementos no segundo balde da chave
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;
+    size_t insercoesDeslocadas;  // inserções que precisaram de um caminho
+    size_t deslocamentos;        // elementos movidos por esses caminhos
+    size_t caminhoMaximo;
+    size_t falhasInsercao;       // buscas sem caminho (elemento no esconderijo)
+    size_t rehashPorFalha;       // redimensionamentos por esconderijo cheio
+    double cargaMaxima;
+    double cargaMinima;
+    size_t capacidadeReservada;
+    PoliticaHash politica;
+    Hasher hasher;
+    Igual igual;
+    mutable Instrumentacao instrumentacao;  // localizar é const
+    
+    // Mistura do hash para o segundo balde: a política é aplicada a um valor que
+    // praticamente não guarda relação com o hash original
+    static size_t remisturar(size_t hash) {
+        unsigned long long x = hash ^ 0x5851F42D4C957F2DULL;
+        x = (x ^ (x >> 32)) * 0xC2B2AE3D27D4EB4FULL;
+        return (size_t)(x ^ (x >> 29));
+    }
+    
+    size_t balde1(size_t hash) const { return politica.indice(hash); }
+    size_t balde2(size_t hash) const { return politica.indice(remisturar(hash)); }
+    
+    size_t outroBalde(size_t hash, size_t balde) const {
+        size_t primeiro = balde1(hash);
+        return primeiro != balde ? primeiro : balde2(hash);
+    }
+    
+    // Primeira posição livre do balde ou POSICOES_BALDE
+    size_t posicaoLivre(size_t balde) const {
+        unsigned livres = ~tabela[balde].ocupadas & ((1u << POSICOES_BALDE) - 1);
+        return livres != 0 ? __builtin_ctz(livres) : POSICOES_BALDE;
+    }
+    
+    template <typename Consulta>
+    size_t procurarNoBalde(size_t balde, const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+        const Balde& atual = tabela[balde];
+        instrumentacao.baldes(operacao, 1);
+        for (size_t p = 0; p < POSICOES_BALDE; p++) {
+            if (!(atual.ocupadas >> p & 1)) {
+                continue;
+            }
+            instrumentacao.comparacoes(operacao, 1);
+            if (atual.hashes[p] == hash && igual(atual.chaves[p], chave)) {
+                return balde * POSICOES_BALDE + p;
+            }
+        }
+        return capacidade;
+    }
+    
+    // Posição da chave nos seus dois baldes (balde · POSICOES_BALDE + posição);
+    // capacidade quando não está em nenhum. O segundo balde é pedido antes de o primeiro
+    // ser comparado, então as duas faltas de cache se sobrepõem
+    template <typename Consulta>
+    size_t localizar(const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+        size_t segundo = balde2(hash);
+        precarregar(&tabela[segundo]);
+        size_t indice = procurarNoBalde(balde1(hash), chave, hash, operacao);
+        return indice != capacidade ? indice : procurarNoBalde(segundo, chave, hash, operacao);
+    }
+    
+    Valor& valorEm(size_t indice) { return tabela[indice / POSICOES_BALDE].valores[indice % POSICOES_BALDE]; }
+    const Valor& valorEm(size_t indice) const {
+        return tabela[indice / POSICOES_BALDE].valores[indice % POSICOES_BALDE];
+    }
+    
+    template <typename Consulta>
+    size_t localizarNoEsconderijo(const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+        instrumentacao.baldes(operacao, 1);
+        for (size_t i = 0; i < esconderijo.size(); i++) {
+            instrumentacao.comparacoes(operacao, 1);
+            if (esconderijo[i].hash == hash && igual(esconderijo[i].chave, chave)) {
+                return i;
+            }
+        }
+        return esconderijo.size();
+    }
+    
+    void ocupar(size_t balde, size_t posicao, Chave chave, Valor valor, size_t hash) {
+        Balde& destino = tabela[balde];
+        size_t ocupadas = __builtin_popcount(destino.ocupadas);
+        ocupacao.mudar(ocupadas, ocupadas + 1);
+        secundarios += balde != balde1(hash);
+        destino.chaves[posicao] = move(chave);
+        destino.valores[posicao] = move(valor);
+        destino.hashes[posicao] = hash;
+        destino.ocupadas |= 1u << posicao;
+    }
+    
+    void liberar(size_t balde, size_t posicao) {
+        Balde& origem = tabela[balde];
+        size_t ocupadas = __builtin_popcount(origem.ocupadas);
+        ocupacao.mudar(ocupadas, ocupadas - 1);
+        secundarios -= balde != balde1(origem.hashes[posicao]);
+        origem.ocupadas &= ~(1u << posicao);
+        origem.chaves[posicao] = Chave();
+    }
+    
+    void mover(size_t deBalde, size_t dePosicao, size_t paraBalde, size_t paraPosicao) {
+        Balde& origem = tabela[deBalde];
+        ocupar(paraBalde, paraPosicao, move(origem.chaves[dePosicao]), move(origem.valores[dePosicao]),
+               origem.hashes[dePosicao]);
+        liberar(deBalde, dePosicao);
+    }
+    
+    // Busca em largura a partir dos dois baldes da chave. Achando um elemento cujo outro
+    // balde tem posição livre, executa o caminho de trás para frente (cada elemento vai
+    // para a posição que o seguinte liberou) e devolve a posição aberta num dos baldes
+    // de origem. O caminho mais curto não repete balde, então os movimentos são válidos
+    bool abrirEspaco(size_t primeiro, size_t segundo, size_t& balde, size_t& posicao) {
+        No nos[NOS_BUSCA];
+        size_t quantidade = 0;
+        nos[quantidade++] = {primeiro, -1, 0};
+        if (segundo != primeiro) {
+            nos[quantidade++] = {segundo, -1, 0};
+        }
+        
+        for (size_t atual = 0; atual < quantidade; atual++) {
+            for (unsigned p = 0; p < POSICOES_BALDE; p++) {
+                size_t origem = nos[atual].balde;
+                size_t destino = outroBalde(tabela[origem].hashes[p], origem);
+                size_t livre = destino != origem ? posicaoLivre(destino) : POSICOES_BALDE;
+                
+                if (livre != POSICOES_BALDE) {
+                    size_t movidos = 0;
+                    int no = (int)atual;
+                    size_t dePosicao = p;
+                    while (true) {
+                        mover(nos[no].balde, dePosicao, destino, livre);
+                        movidos++;
+                        if (nos[no].anterior < 0) {
+                            break;
+                        }
+                        destino = nos[no].balde;
+                        livre = dePosicao;
+                        dePosicao = nos[no].posicao;
+                        no = nos[no].anterior;
+                    }
+                    balde = nos[no].balde;
+                    posicao = dePosicao;
+                    insercoesDeslocadas++;
+                    deslocamentos += movidos;
+                    caminhoMaximo = max(caminhoMaximo, movidos);
+                    return true;
+                }
+                if (quantidade < NOS_BUSCA) {
+                    nos[quantidade++] = {destino, (int)atual, p};
+                }
+            }
+        }
+        return false;
+    }
+    
+    // Insere uma chave que sabidamente não está na tabela; sem caminho, vai para o
+    // esconderijo, que pode passar do limite até quem chamou refazer a tabela
+    void posicionar(Chave chave, Valor valor, size_t hash) {
+        size_t primeiro = balde1(hash);
+        size_t segundo = balde2(hash);
+        size_t balde = primeiro;
+        size_t posicao = posicaoLivre(primeiro);
+        
+        if (posicao == POSICOES_BALDE) {
+            balde = segundo;
+            posicao = posicaoLivre(segundo);
+        }
+        if (posicao == POSICOES_BALDE && !abrirEspaco(primeiro, segundo, balde, posicao)) {
+            falhasInsercao++;
+            esconderijo.emplace_back(move(chave), move(valor), hash);
+        } else {
+            ocupar(balde, posicao, move(chave), move(valor), hash);
+        }
+        elementos++;
+    }
+    
+    // Remoções liberam posições: devolve aos baldes o que couber do esconderijo e conta
+    // os elementos devolvidos como movidos pela remoção
+    void esvaziarEsconderijo() {
+        for (size_t i = 0; i < esconderijo.size();) {
+            TipoElemento& elem = esconderijo[i];
+            size_t balde = balde1(elem.hash);
+            size_t posicao = posicaoLivre(balde);
+            if (posicao == POSICOES_BALDE) {
+                balde = balde2(elem.hash);
+                posicao = posicaoLivre(balde);
+            }
+            if (posicao == POSICOES_BALDE) {
+                i++;
+                continue;
+            }
+            ocupar(balde, posicao, move(elem.chave), move(elem.valor), elem.hash);
+            esconderijo.erase(esconderijo.begin() + i);
+            instrumentacao.movidos(OperacaoTabela::REMOCAO, 1);
+        }
+    }
+    
+    void alocar(size_t novaCapacidade) {
+        baldes = PoliticaHash::capacidadeValida(max((size_t)2, (novaCapacidade + POSICOES_BALDE - 1) / POSICOES_BALDE));
+        politica.ajustar(baldes);
+        capacidade = baldes * POSICOES_BALDE;
+        tabela.assign(baldes, Balde());
+        ocupacao.limpar();
+        ocupacao.adicionar(0, baldes);
+        secundarios = 0;
+        esconderijo.clear();
+        elementos = 0;
+    }
+    
+    // Se o esconderijo passar do limite no meio da reinserção, refaz com o dobro. causa: a
+    // operação que pediu o redimensionamento (reservar conta como inserção)
+    void redimensionar(size_t novaCapacidade, OperacaoTabela causa) {
+        long long inicio = agoraNs();
+        size_t capacidadeAnterior = capacidade;
+        size_t bytes = 0;
+        
+        do {
+            Vetor<Balde> antiga = move(tabela);
+            Vetor<TipoElemento> esconderijoAntigo = move(esconderijo);
+            
+            alocar(novaCapacidade);
+            
+            // O hash guardado evita recalcular o hash das chaves
+            for (Balde& balde : antiga) {
+                for (size_t p = 0; p < POSICOES_BALDE; p++) {
+                    if (balde.ocupadas >> p & 1) {
+                        posicionar(move(balde.chaves[p]), move(balde.valores[p]), balde.hashes[p]);
+                    }
+                }
+            }
+            for (TipoElemento& elem : esconderijoAntigo) {
+                posicionar(move(elem.chave), move(elem.valor), elem.hash);
+            }
+            bytes += baldes * sizeof(Balde) + esconderijo.size() * sizeof(TipoElemento);
+            instrumentacao.alocacoes(causa, 1);
+            instrumentacao.movidos(causa, elementos);
+            novaCapacidade = capacidade * 2;
+        } while (esconderijo.size() > ESCONDERIJO_MAXIMO);
+        
+        redimensionamentos++;
+        eventos.push_back({inicio, agoraNs(), capacidadeAnterior, capacidade, elementos, bytes});
+    }
+    
+public:
+    TabelaCuckoo(size_t capacidadeInicial = 8, double maxCarga = 0.95, double minCarga = 0.2)
+        : baldes(0), capacidade(0), elementos(0), secundarios(0), redimensionamentos(0), insercoesDeslocadas(0),
+          deslocamentos(0), caminhoMaximo(0), falhasInsercao(0), rehashPorFalha(0), cargaMaxima(maxCarga),
+          cargaMinima(minCarga), capacidadeReservada(0) {
+        alocar(capacidadeInicial);
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        size_t indice = localizar(chave, hash, OperacaoTabela::INSERCAO);
+        if (indice != capacidade) {
+            valorEm(indice) = move(valor);
+            return;
+        }
+        if (!esconderijo.empty()) {
+            size_t guardado = localizarNoEsconderijo(chave, hash, OperacaoTabela::INSERCAO);
+            if (guardado != esconderijo.size()) {
+                esconderijo[guardado].valor = move(valor);
+                return;
+            }
+        }
+        
+        if ((double)(elementos + 1) / capacidade > cargaMaxima) {
+            redimensionar(capacidade * 2, OperacaoTabela::INSERCAO);
+        }
+        
+        // Os deslocamentos do caminho são os movidos da inserção; o esconderijo só aloca
+        // quando o vetor cresce
+        size_t deslocamentosAntes = deslocamentos;
+        size_t esconderijoAntes = esconderijo.capacity();
+        posicionar(move(chave), move(valor), hash);
+        instrumentacao.movidos(OperacaoTabela::INSERCAO, deslocamentos - deslocamentosAntes);
+        instrumentacao.alocacoes(OperacaoTabela::INSERCAO, esconderijo.capacity() != esconderijoAntes);
+        
+        if (esconderijo.size() > ESCONDERIJO_MAXIMO) {
+            rehashPorFalha++;
+            redimensionar(capacidade * 2, OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        size_t indice = localizar(chave, hash, OperacaoTabela::BUSCA);
+        if (indice != capacidade) {
+            valorEncontrado = valorEm(indice);
+            return true;
+        }
+        if (!esconderijo.empty()) {
+            size_t guardado = localizarNoEsconderijo(chave, hash, OperacaoTabela::BUSCA);
+            if (guardado != esconderijo.size()) {
+                valorEncontrado = esconderijo[guardado].valor;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        size_t indice = localizar(chave, hash, OperacaoTabela::REMOCAO);
+        
+        if (indice != capacidade) {
+            liberar(indice / POSICOES_BALDE, indice % POSICOES_BALDE);
+            if (!esconderijo.empty()) {
+                esvaziarEsconderijo();
+            }
+        } else {
+            size_t guardado = esconderijo.empty() ? 0 : localizarNoEsconderijo(chave, hash, OperacaoTabela::REMOCAO);
+            if (guardado == esconderijo.size()) {
+                return false;
+            }
+            esconderijo.erase(esconderijo.begin() + guardado);
+        }
+        elementos--;
+        
+        if (capacidade > 8 && capacidade > capacidadeReservada && obterFatorCarga() <= cargaMinima) {
+            redimensionar(capacidade / 2, OperacaoTabela::REMOCAO);
+        }
+        
+        return true;
+    }
+    
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima com no máximo um rehash; a
+    // tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        size_t pedidos = capacidadeParaCarga(n, cargaMaxima);
+        capacidadeReservada = PoliticaHash::capacidadeValida((pedidos + POSICOES_BALDE - 1) / POSICOES_BALDE) *
+                              POSICOES_BALDE;
+        if (capacidadeReservada > capacidade) {
+            redimensionar(capacidadeReservada, OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    // reservar para o total e inserções em sequência, sem nenhum rehash por carga no
+    // caminho. Sem threads: um caminho de deslocamentos pode passar por qualquer balde
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned = 0) {
+        reservar(elementos + pares.size());
+        for (const auto& [chave, valor] : pares) {
+            inserir(chave, valor);
+        }
+    }
+    
+    // Pede os dois baldes de cada chave do lote antes de comparar qualquer um
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        size_t hashesLote[LOTE_PRECARGA];
+        size_t achados = 0;
+        
+        for (size_t base = 0; base < quantidade; base += LOTE_PRECARGA) {
+            size_t tamanho = min(LOTE_PRECARGA, quantidade - base);
+            
+            for (size_t j = 0; j < tamanho; j++) {
+                instrumentacao.operacao(OperacaoTabela::BUSCA);
+                instrumentacao.hash(OperacaoTabela::BUSCA);
+                hashesLote[j] = hasher(consultas[base + j]);
+                precarregar(&tabela[balde1(hashesLote[j])]);
+                precarregar(&tabela[balde2(hashesLote[j])]);
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                const Consulta& chave = consultas[base + j];
+                size_t indice = localizar(chave, hashesLote[j], OperacaoTabela::BUSCA);
+                encontrados[base + j] = indice != capacidade;
+                if (indice != capacidade) {
+                    resultados[base + j] = valorEm(indice);
+                } else if (!esconderijo.empty()) {
+                    size_t guardado = localizarNoEsconderijo(chave, hashesLote[j], OperacaoTabela::BUSCA);
+                    if (guardado != esconderijo.size()) {
+                        resultados[base + j] = esconderijo[guardado].valor;
+                        encontrados[base + j] = true;
+                    }
+                }
+                achados += encontrados[base + j];
+            }
+        }
+        return achados;
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &tabela[balde1(hash)]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de posição e depois o esconderijo
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        for (const Balde& balde : tabela) {
+            for (size_t p = 0; p < POSICOES_BALDE; p++) {
+                if (balde.ocupadas >> p & 1) {
+                    visitar(balde.chaves[p], balde.valores[p]);
+                }
+            }
+        }
+        for (const TipoElemento& elem : esconderijo) {
+            visitar(elem.chave, elem.valor);
+        }
+    }
+    
+    // Elementos fora do primeiro balde da chave: no segundo ou no esconderijo
+    size_t obterColisoes() const { return secundarios + esconderijo.size(); }
+    // Cadeia de um balde: as posições ocupadas. Sondas são baldes lidos: 1 para quem está
+    // no primeiro balde, 2 no segundo, 3 no esconderijo (os dois baldes e ele); uma
+    // chave ausente lê os dois baldes e, se houver, o esconderijo
+    EstatisticasTabela obterEstatisticas() const {
+        EstatisticasTabela estatisticas;
+        estatisticas.elementos = elementos;
+        estatisticas.capacidade = baldes;
+        estatisticas.baldesOcupados = baldes - ocupacao[0];
+        estatisticas.cadeiaMaxima = ocupacao.obterMaximo();
+        estatisticas.histograma = ocupacao.obterContagens();
+        
+        size_t guardados = esconderijo.size();
+        size_t primarios = elementos - secundarios - guardados;
+        estatisticas.sondasAcerto =
+            elementos > 0 ? (double)(primarios + 2 * secundarios + 3 * guardados) / elementos : 0.0;
+        estatisticas.sondasFalha = guardados > 0 ? 3.0 : 2.0;
+        return estatisticas;
+    }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    size_t obterCaminhoMaximo() const { return caminhoMaximo; }
+    double obterCaminhoMedio() const {
+        return insercoesDeslocadas > 0 ? (double)deslocamentos / insercoesDeslocadas : 0.0;
+    }
+    size_t obterInsercoesDeslocadas() const { return insercoesDeslocadas; }
+    size_t obterFalhasInsercao() const { return falhasInsercao; }
+    size_t obterRehashPorFalha() const { return rehashPorFalha; }
+    size_t obterEsconderijo() const { return esconderijo.size(); }
+    double obterFatorCarga() const {
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0;
+    }
+};
+
+// Tabela HASH - HASHING EXTENSÍVEL
+// Um diretório de 2^profundidadeGlobal ponteiros, indexado pelos bits altos do hash
+// misturado, aponta para páginas de TAMANHO_PAGINA bytes alinhadas à página do sistema,
+// cada uma com a sua profundidade local. Página cheia divide só ela mesma pelo bit
+// seguinte do hash, e o diretório (só ponteiros) dobra quando a página já usa todos os
+// bits dele: nenhum crescimento copia mais que uma página e o diretório. Remoções juntam
+// páginas irmãs que caibam juntas abaixo de cargaMinima, e o diretório encolhe quando
+// nenhuma página usa o último bit. Dentro da página os elementos ficam compactos e a
+// busca percorre os hashes em sequência. Como a TabelaLinear, não recebe PoliticaHash:
+// o endereço são bits do hash, não uma redução ao tamanho
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao>
+class TabelaExtensivel {
+private:
+    static const size_t TAMANHO_PAGINA = 4096;
+    static const size_t BYTES_ENTRADA = sizeof(size_t) + sizeof(Chave) + sizeof(Valor);
+    static const size_t POSICOES_PAGINA = (TAMANHO_PAGINA - 2 * sizeof(uint32_t)) / BYTES_ENTRADA;
+    static const unsigned PROFUNDIDADE_MAXIMA = 63;
+    
+    struct alignas(TAMANHO_PAGINA) Pagina {
+        uint32_t profundidadeLocal;
+        uint32_t quantidade;
+        size_t hashes[POSICOES_PAGINA];
+        Chave chaves[POSICOES_PAGINA];
+        Valor valores[POSICOES_PAGINA];
+    };
+    static_assert(sizeof(Pagina) == TAMANHO_PAGINA, "as entradas não cabem em uma página");
+    
+    using AlocadorPagina = typename allocator_traits<Alocador>::template rebind_alloc<Pagina>;
+    using Diretorio = vector<Pagina*, typename allocator_traits<Alocador>::template rebind_alloc<Pagina*>>;
+    
+    AlocadorPagina alocadorPagina;
+    Diretorio diretorio;
+    unsigned profundidadeGlobal;
+    unsigned profundidadeInicial;
+    unsigned profundidadeMinima;  // inicial ou reservada: nada junta nem encolhe abaixo dela
+    size_t paginas;
+    size_t paginasNoLimite;       // páginas com profundidade local = global
+    size_t elementos;
+    HistogramaComprimentos ocupacao;  // páginas por entradas ocupadas
+    double cargaAusente;              // Σ entradas · 2^-profundidadeLocal, ver obterEstatisticas
+    size_t redimensionamentos;
+    size_t divisoes;
+    size_t bytesDivisaoMaximo;
+    vector<EventoRedimensionamento> eventos;  // o último fica aberto até o diretório mudar
+    bool eventoAberto;
+    bool eventoCrescendo;
+    double cargaMaxima;           // fração da página que a faz dividir
+    double cargaMinima;
+    uint32_t limiteDivisao;
+    uint32_t limiteJuncao;
+    Hasher hasher;
+    Igual igual;
+    mutable Instrumentacao instrumentacao;  // buscarLote é const
+    
+    // Multiplicação de Fibonacci: os bits altos, que endereçam o diretório, dependem de
+    // todos os bits do hash
+    static uint64_t misturar(size_t hash) { return hash * 0x9E3779B97F4A7C15ULL; }
+    
+    // Fração do diretório que aponta para a página
+    static double peso(const Pagina* pagina) { return ldexp(1.0, -(int)pagina->profundidadeLocal); }
+    
+    size_t indiceDiretorio(size_t hash) const {
+        return (size_t)((misturar(hash) >> 1) >> (PROFUNDIDADE_MAXIMA - profundidadeGlobal));
+    }
+    
+    template <typename Consulta>
+    uint32_t localizarNaPagina(const Pagina* pagina, const Consulta& chave, size_t hash,
+                               OperacaoTabela operacao) const {
+        instrumentacao.baldes(operacao, 1);
+        for (uint32_t j = 0; j < pagina->quantidade; j++) {
+            instrumentacao.comparacoes(operacao, 1);
+            if (pagina->hashes[j] == hash && igual(pagina->chaves[j], chave)) {
+                return j;
+            }
+        }
+        return pagina->quantidade;
+    }
+    
+    Pagina* criarPagina(unsigned profundidade) {
+        Pagina* pagina = allocator_traits<AlocadorPagina>::allocate(alocadorPagina, 1);
+        allocator_traits<AlocadorPagina>::construct(alocadorPagina, pagina);
+        pagina->profundidadeLocal = profundidade;
+        ocupacao.adicionar(0);
+        paginas++;
+        return pagina;
+    }
+    
+    void destruirPagina(Pagina* pagina) {
+        ocupacao.retirar(pagina->quantidade);
+        allocator_traits<AlocadorPagina>::destroy(alocadorPagina, pagina);
+        allocator_traits<AlocadorPagina>::deallocate(alocadorPagina, pagina, 1);
+        paginas--;
+    }
+    
+    // Cada página ocupa uma faixa alinhada de 2^(global - local) entradas do diretório
+    size_t larguraFaixa(const Pagina* pagina) const {
+        return (size_t)1 << (profundidadeGlobal - pagina->profundidadeLocal);
+    }
+    
+    template <typename Visitante>
+    void paraCadaPagina(Visitante&& visitar) const {
+        for (size_t i = 0; i < diretorio.size(); i += larguraFaixa(diretorio[i])) {
+            visitar(diretorio[i]);
+        }
+    }
+    
+    void moverEntrada(Pagina* origem, uint32_t de, Pagina* destino, uint32_t para) {
+        destino->hashes[para] = origem->hashes[de];
+        destino->chaves[para] = move(origem->chaves[de]);
+        destino->valores[para] = move(origem->valores[de]);
+    }
+    
+    // Um evento por profundidade global: aberto na primeira divisão ou junção e fechado
+    // quando o diretório dobra ou encolhe, ou quando o sentido muda
+    void anotar(bool crescendo, size_t capacidadeAnterior, size_t movidos, size_t bytes) {
+        if (eventoAberto && eventoCrescendo != crescendo) {
+            fecharEvento();
+        }
+        if (!eventoAberto) {
+            eventos.push_back({agoraNs(), 0, capacidadeAnterior, 0, 0, 0});
+            eventoAberto = true;
+            eventoCrescendo = crescendo;
+        }
+        eventos.back().capacidadeNova = obterCapacidade();
+        eventos.back().elementosMovidos += movidos;
+        eventos.back().bytesMovidos += bytes;
+    }
+    
+    void fecharEvento() {
+        eventos.back().fimNs = agoraNs();
+        eventoAberto = false;
+        redimensionamentos++;
+    }
+    
+    // Só ponteiros: a entrada i vira 2i e 2i + 1. Devolve os bytes escritos; causa: a
+    // operação que pediu a divisão (reservar conta como inserção)
+    size_t dobrarDiretorio(OperacaoTabela causa) {
+        if (eventoAberto) {
+            fecharEvento();
+        }
+        Diretorio novo(diretorio.size() * 2, nullptr, diretorio.get_allocator());
+        for (size_t i = 0; i < diretorio.size(); i++) {
+            novo[2 * i] = novo[2 * i + 1] = diretorio[i];
+        }
+        diretorio = move(novo);
+        profundidadeGlobal++;
+        paginasNoLimite = 0;
+        instrumentacao.alocacoes(causa, 1);
+        
+        size_t bytes = diretorio.size() * sizeof(Pagina*);
+        anotar(true, obterCapacidade(), 0, bytes);
+        return bytes;
+    }
+    
+    void encolherDiretorio() {
+        if (eventoAberto) {
+            fecharEvento();
+        }
+        Diretorio novo(diretorio.size() / 2, nullptr, diretorio.get_allocator());
+        for (size_t i = 0; i < novo.size(); i++) {
+            novo[i] = diretorio[2 * i];
+        }
+        diretorio = move(novo);
+        profundidadeGlobal--;
+        instrumentacao.alocacoes(OperacaoTabela::REMOCAO, 1);
+        paginasNoLimite = 0;
+        paraCadaPagina([&](const Pagina* pagina) { paginasNoLimite += pagina->profundidadeLocal == profundidadeGlobal; });
+        anotar(false, obterCapacidade(), 0, diretorio.size() * sizeof(Pagina*));
+    }
+    
+    // Divide a página da entrada indice do diretório pelo bit seguinte do hash: quem tem
+    // o bit ligado vai para a irmã, que assume a metade de cima da faixa
+    void dividir(size_t indice, OperacaoTabela causa) {
+        Pagina* pagina = diretorio[indice];
+        unsigned profundidade = pagina->profundidadeLocal;
+        size_t capacidadeAnterior = obterCapacidade();
+        size_t bytesDiretorio = 0;
+        
+        if (profundidade == profundidadeGlobal) {
+            if (profundidadeGlobal == PROFUNDIDADE_MAXIMA) {
+                throw runtime_error("página sem bit de hash para dividir");
+            }
+            bytesDiretorio = dobrarDiretorio(causa);
+            indice *= 2;
+        }
+        
+        Pagina* irma = criarPagina(profundidade + 1);
+        instrumentacao.alocacoes(causa, 1);
+        uint32_t quantidade = pagina->quantidade;
+        cargaAusente -= ldexp((double)quantidade, -(int)(profundidade + 1));
+        pagina->profundidadeLocal = profundidade + 1;
+        unsigned bit = PROFUNDIDADE_MAXIMA - profundidade;
+        uint32_t mantidos = 0;
+        size_t reescritos = 0;
+        for (uint32_t j = 0; j < pagina->quantidade; j++) {
+            if (misturar(pagina->hashes[j]) >> bit & 1) {
+                moverEntrada(pagina, j, irma, irma->quantidade++);
+            } else {
+                if (mantidos != j) {
+                    moverEntrada(pagina, j, pagina, mantidos);
+                    reescritos++;
+                }
+                mantidos++;
+            }
+        }
+        pagina->quantidade = mantidos;
+        ocupacao.mudar(quantidade, mantidos);
+        ocupacao.mudar(0, irma->quantidade);
+        
+        size_t largura = larguraFaixa(irma) * 2;
+        size_t inicio = indice & ~(largura - 1);
+        for (size_t i = inicio + largura / 2; i < inicio + largura; i++) {
+            diretorio[i] = irma;
+        }
+        if (profundidade + 1 == profundidadeGlobal) {
+            paginasNoLimite += 2;
+        }
+        
+        // A página nova inteira (zerada e depois preenchida), o que a antiga compactou e a metade da faixa
+        size_t bytes = TAMANHO_PAGINA + reescritos * BYTES_ENTRADA + largura / 2 * sizeof(Pagina*);
+        divisoes++;
+        bytesDivisaoMaximo = max(bytesDivisaoMaximo, bytes + bytesDiretorio);
+        anotar(true, capacidadeAnterior, irma->quantidade, bytes);
+        instrumentacao.movidos(causa, irma->quantidade);
+    }
+    
+    // Junta a página da entrada indice com a irmã se as duas couberem abaixo de cargaMinima;
+    // fica a de prefixo menor. Só a remoção junta
+    void tentarJuntar(size_t indice) {
+        Pagina* pagina = diretorio[indice];
+        unsigned profundidade = pagina->profundidadeLocal;
+        if (profundidade <= profundidadeMinima) {
+            return;
+        }
+        size_t largura = larguraFaixa(pagina);
+        size_t inicio = indice & ~(largura - 1);
+        Pagina* irma = diretorio[inicio ^ largura];
+        if (irma->profundidadeLocal != profundidade || pagina->quantidade + irma->quantidade > limiteJuncao) {
+            return;
+        }
+        
+        size_t capacidadeAnterior = obterCapacidade();
+        Pagina* fica = (inicio & largura) == 0 ? pagina : irma;
+        Pagina* sai = fica == pagina ? irma : pagina;
+        size_t movidos = sai->quantidade;
+        cargaAusente += ldexp((double)(fica->quantidade + sai->quantidade), -(int)profundidade);
+        ocupacao.mudar(fica->quantidade, fica->quantidade + sai->quantidade);
+        for (uint32_t j = 0; j < sai->quantidade; j++) {
+            moverEntrada(sai, j, fica, fica->quantidade++);
+        }
+        fica->profundidadeLocal = profundidade - 1;
+        for (size_t i = inicio & ~largura; i < (inicio & ~largura) + 2 * largura; i++) {
+            diretorio[i] = fica;
+        }
+        if (profundidade == profundidadeGlobal) {
+            paginasNoLimite -= 2;
+        }
+        destruirPagina(sai);
+        instrumentacao.movidos(OperacaoTabela::REMOCAO, movidos);
+        anotar(false, capacidadeAnterior, movidos, movidos * BYTES_ENTRADA + largura * sizeof(Pagina*));
+        
+        while (paginasNoLimite == 0 && profundidadeGlobal > profundidadeMinima) {
+            encolherDiretorio();
+        }
+    }
+    
+public:
+    TabelaExtensivel(size_t capacidadeInicial = 8, double maxCarga = 1.0, double minCarga = 0.2)
+        : profundidadeGlobal(0), profundidadeInicial(0), paginas(0), paginasNoLimite(0), elementos(0), cargaAusente(0),
+          redimensionamentos(0), divisoes(0), bytesDivisaoMaximo(0), eventoAberto(false), eventoCrescendo(true),
+          cargaMaxima(maxCarga), cargaMinima(minCarga) {
+        limiteDivisao = (uint32_t)max((size_t)1, min((size_t)POSICOES_PAGINA, (size_t)(POSICOES_PAGINA * cargaMaxima)));
+        limiteJuncao = (uint32_t)(2 * POSICOES_PAGINA * cargaMinima);
+        
+        while (((size_t)POSICOES_PAGINA << profundidadeInicial) < capacidadeInicial) {
+            profundidadeInicial++;
+        }
+        profundidadeGlobal = profundidadeMinima = profundidadeInicial;
+        diretorio.resize((size_t)1 << profundidadeGlobal);
+        for (Pagina*& pagina : diretorio) {
+            pagina = criarPagina(profundidadeGlobal);
+        }
+        paginasNoLimite = paginas;
+    }
+    
+    TabelaExtensivel(const TabelaExtensivel&) = delete;
+    TabelaExtensivel& operator=(const TabelaExtensivel&) = delete;
+    
+    ~TabelaExtensivel() {
+        vector<Pagina*> unicas;
+        paraCadaPagina([&](Pagina* pagina) { unicas.push_back(pagina); });
+        for (Pagina* pagina : unicas) {
+            destruirPagina(pagina);
+        }
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        size_t indice = indiceDiretorio(hash);
+        Pagina* pagina = diretorio[indice];
+        uint32_t posicao = localizarNaPagina(pagina, chave, hash, OperacaoTabela::INSERCAO);
+        if (posicao != pagina->quantidade) {
+            pagina->valores[posicao] = move(valor);
+            return;
+        }
+        
+        // Página cheia: divide até a metade da chave ter lugar (quase sempre uma vez)
+        if (pagina->quantidade >= limiteDivisao) {
+            do {
+                dividir(indice, OperacaoTabela::INSERCAO);
+                indice = indiceDiretorio(hash);
+                pagina = diretorio[indice];
+            } while (pagina->quantidade >= limiteDivisao);
+        }
+        
+        ocupacao.mudar(pagina->quantidade, pagina->quantidade + 1);
+        cargaAusente += peso(pagina);
+        uint32_t j = pagina->quantidade++;
+        pagina->hashes[j] = hash;
+        pagina->chaves[j] = move(chave);
+        pagina->valores[j] = move(valor);
+        elementos++;
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t hash = hasher(chave);
+        const Pagina* pagina = diretorio[indiceDiretorio(hash)];
+        uint32_t posicao = localizarNaPagina(pagina, chave, hash, OperacaoTabela::BUSCA);
+        if (posicao == pagina->quantidade) {
+            return false;
+        }
+        valorEncontrado = pagina->valores[posicao];
+        return true;
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t hash = hasher(chave);
+        size_t indice = indiceDiretorio(hash);
+        Pagina* pagina = diretorio[indice];
+        uint32_t posicao = localizarNaPagina(pagina, chave, hash, OperacaoTabela::REMOCAO);
+        if (posicao == pagina->quantidade) {
+            return false;
+        }
+        
+        // A última entrada ocupa o buraco, e a página continua compacta
+        ocupacao.mudar(pagina->quantidade, pagina->quantidade - 1);
+        cargaAusente -= peso(pagina);
+        uint32_t ultima = --pagina->quantidade;
+        if (posicao != ultima) {
+            moverEntrada(pagina, ultima, pagina, posicao);
+        }
+        pagina->chaves[ultima] = Chave();
+        elementos--;
+        
+        tentarJuntar(indice);
+        return true;
+    }
+    
+    // Divide as páginas até 2^d delas comportarem n elementos a 70% de cargaMaxima (folga
+    // para a variação entre páginas); nada junta abaixo disso (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        size_t paginasAlvo = (capacidadeParaCarga(n, 0.7 * cargaMaxima) + POSICOES_PAGINA - 1) / POSICOES_PAGINA;
+        unsigned profundidade = 0;
+        while (((size_t)1 << profundidade) < paginasAlvo && profundidade < PROFUNDIDADE_MAXIMA) {
+            profundidade++;
+        }
+        profundidadeMinima = max(profundidadeInicial, profundidade);
+        
+        while (profundidadeGlobal < profundidade) {
+            dobrarDiretorio(OperacaoTabela::INSERCAO);
+        }
+        for (size_t i = 0; i < diretorio.size();) {
+            if (diretorio[i]->profundidadeLocal < profundidade) {
+                dividir(i, OperacaoTabela::INSERCAO);
+            } else {
+                i += larguraFaixa(diretorio[i]);
+            }
+        }
+    }
+    
+    // reservar para o total e inserções em sequência; depois da reserva quase nenhuma
+    // página divide. Sem threads: uma divisão pode dobrar o diretório de todas
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned = 0) {
+        reservar(elementos + pares.size());
+        for (const auto& [chave, valor] : pares) {
+            inserir(chave, valor);
+        }
+    }
+    
+    // Pede as entradas do diretório do lote, depois as páginas, e só então compara
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        size_t hashesLote[LOTE_PRECARGA];
+        size_t indices[LOTE_PRECARGA];
+        size_t achados = 0;
+        
+        for (size_t base = 0; base < quantidade; base += LOTE_PRECARGA) {
+            size_t tamanho = min(LOTE_PRECARGA, quantidade - base);
+            
+            for (size_t j = 0; j < tamanho; j++) {
+                instrumentacao.operacao(OperacaoTabela::BUSCA);
+                instrumentacao.hash(OperacaoTabela::BUSCA);
+                hashesLote[j] = hasher(consultas[base + j]);
+                indices[j] = indiceDiretorio(hashesLote[j]);
+                precarregar(&diretorio[indices[j]]);
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                precarregar(diretorio[indices[j]]);
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                const Pagina* pagina = diretorio[indices[j]];
+                uint32_t posicao =
+                    localizarNaPagina(pagina, consultas[base + j], hashesLote[j], OperacaoTabela::BUSCA);
+                encontrados[base + j] = posicao != pagina->quantidade;
+                if (encontrados[base + j]) {
+                    resultados[base + j] = pagina->valores[posicao];
+                    achados++;
+                }
+            }
+        }
+        return achados;
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &diretorio[indiceDiretorio(hash)]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, página por página na ordem do diretório
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        paraCadaPagina([&](const Pagina* pagina) {
+            for (uint32_t j = 0; j < pagina->quantidade; j++) {
+                visitar(pagina->chaves[j], pagina->valores[j]);
+            }
+        });
+    }
+    
+    // Elementos além do primeiro de cada página
+    size_t obterColisoes() const { return elementos - (paginas - ocupacao[0]); }
+    // Cadeia de uma página: as entradas ocupadas, percorridas em ordem. Uma chave ausente
+    // cai numa página com a chance da fração do diretório que aponta para ela e compara
+    // todas as entradas: Σ entradas · 2^-profundidadeLocal, mantida a cada mudança
+    EstatisticasTabela obterEstatisticas() const {
+        EstatisticasTabela estatisticas = estatisticasEncadeadas(ocupacao, elementos);
+        estatisticas.sondasFalha = cargaAusente;
+        return estatisticas;
+    }
+    // Posições de todas as páginas
+    size_t obterCapacidade() const { return paginas * POSICOES_PAGINA; }
+    size_t obterElementos() const { return elementos; }
+    // Profundidades globais concluídas: cada uma dobra ou divide por 2 o diretório
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    size_t obterDivisoes() const { return divisoes; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    unsigned obterProfundidadeGlobal() const { return profundidadeGlobal; }
+    // Maior número de bytes escritos por uma divisão, incluindo o diretório dobrado
+    size_t obterBytesDivisaoMaximo() const { return bytesDivisaoMaximo; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    double obterFatorCarga() const {
+        size_t capacidade = obterCapacidade();
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0;
+    }
+};
+
+// Nível de instruções vetoriais usado na sondagem, escolhido em tempo de execução
+enum class NivelSimd { ESCALAR, SSE2, AVX2 };
+
+NivelSimd detectarNivelSimd() {
+#ifdef HASH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return NivelSimd::AVX2;
+    }
+    return NivelSimd::SSE2;  // SSE2 faz parte da base do x86-64
+#else
+    return NivelSimd::ESCALAR;
+#endif
+}
+
+string nomeNivelSimd(NivelSimd nivel) {
+    switch (nivel) {
+        case NivelSimd::AVX2: return "AVX2";
+        case NivelSimd::SSE2: return "SSE2";
+        default: return "ESCALAR";
+    }
+}
+
+// Bytes de controle: vazio e apagado têm o bit de sinal ligado; ocupado guarda 7 bits do hash
+const int8_t CONTROLE_VAZIO = -128;
+const int8_t CONTROLE_APAGADO = -2;
+
+// Sondas: comparam uma janela de LARGURA bytes de controle de uma vez e devolvem
+// uma máscara onde o bit i representa a posição (inicio + i) da janela
+struct SondaEscalar {
+    static const size_t LARGURA = 16;
+
+    static uint32_t iguais(const int8_t* controles, int8_t etiqueta) {
+        uint32_t mascara = 0;
+        for (size_t i = 0; i < LARGURA; i++) {
+            mascara |= (uint32_t)(controles[i] == etiqueta) << i;
+        }
+        return mascara;
+    }
+
+    static uint32_t vazios(const int8_t* controles) {
+        return iguais(controles, CONTROLE_VAZIO);
+    }
+
+    static uint32_t livres(const int8_t* controles) {
+        uint32_t mascara = 0;
+        for (size_t i = 0; i < LARGURA; i++) {
+            mascara |= (uint32_t)(controles[i] < 0) << i;
+        }
+        return mascara;
+    }
+};
+
+#ifdef HASH_X86
+struct SondaSse2 {
+    static const size_t LARGURA = 16;
+
+    static uint32_t iguais(const int8_t* controles, int8_t etiqueta) {
+        __m128i grupo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(controles));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(grupo, _mm_set1_epi8(etiqueta)));
+    }
+
+    static uint32_t vazios(const int8_t* controles) {
+        return iguais(controles, CONTROLE_VAZIO);
+    }
+
+    static uint32_t livres(const int8_t* controles) {
+        __m128i grupo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(controles));
+        return _mm_movemask_epi8(grupo);
+    }
+};
+
+// Compara dois grupos (32 bytes) por instrução; só é chamada se a CPU tiver AVX2
+struct SondaAvx2 {
+    static const size_t LARGURA = 32;
+
+    __attribute__((target("avx2")))
+    static uint32_t iguais(const int8_t* controles, int8_t etiqueta) {
+        __m256i grupo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(controles));
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi8(grupo, _mm256_set1_epi8(etiqueta)));
+    }
+
+    __attribute__((target("avx2")))
+    static uint32_t vazios(const int8_t* controles) {
+        return iguais(controles, CONTROLE_VAZIO);
+    }
+
+    __attribute__((target("avx2")))
+    static uint32_t livres(const int8_t* controles) {
+        __m256i grupo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(controles));
+        return _mm256_movemask_epi8(grupo);
+    }
+};
+#endif
+
+// Tabela HASH - GRUPOS COM BYTES DE CONTROLE (SIMD)
+// Endereçamento aberto com um vetor paralelo de 1 byte por posição. A busca filtra
+// 16 (SSE2) ou 32 (AVX2) etiquetas por instrução e só lê as chaves candidatas.
+// A sondagem é linear por posição, então todas as larguras visitam a mesma ordem.
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename Alocador = AlocadorContado<Elemento<Chave, Valor>>,
+          typename Instrumentacao = SemInstrumentacao>
+class TabelaGruposSimd {
+private:
+    template <typename T>
+    using Vetor = vector<T, typename allocator_traits<Alocador>::template rebind_alloc<T>>;
+
+    // Os primeiros bytes de controle são repetidos após o fim para permitir leituras
+    // de janela que atravessam o fim do vetor sem tratar a volta
+    static const size_t LARGURA_CLONE = 32;
+    static const size_t CAPACIDADE_MINIMA = 32;
+
+    Vetor<int8_t> controles;
+    Vetor<Chave> chaves;
+    Vetor<Valor> valores;
+    Vetor<size_t> hashes;
+    size_t capacidade;  // sempre potência de 2
+    size_t mascara;
+    size_t elementos;
+    size_t apagados;
+    HistogramaComprimentos distancias;  // elementos pela distância à origem, em posições
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;
+    double cargaMaxima;
+    double cargaMinima;
+    size_t capacidadeReservada;
+    NivelSimd nivel;
+    Hasher hasher;
+    Igual igual;
+    mutable Instrumentacao instrumentacao;  // localizar é const
+
+    static unsigned long long espalhar(size_t hash) {
+        // Espalha o hash base por 64 bits: os bits baixos escolhem a posição e os 7 altos a etiqueta
+        return hashCompleto(hash) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    static int8_t etiqueta(unsigned long long hash) {
+        return (int8_t)(hash >> 57);
+    }
+
+    // Posições entre a origem do hash e a posição indice, na ordem da sondagem
+    size_t distancia(size_t hash, size_t indice) const {
+        return (indice - (espalhar(hash) & mascara)) & mascara;
+    }
+
+    // Posições comparadas por janela no nível da tabela
+    size_t larguraJanela() const {
+        return nivel == NivelSimd::AVX2 ? 32 : 16;
+    }
+
+    void definirControle(size_t indice, int8_t valor) {
+        controles[indice] = valor;
+        if (indice < LARGURA_CLONE) {
+            controles[capacidade + indice] = valor;
+        }
+    }
+
+    template <typename Sonda, typename Consulta>
+    // Cada janela lida conta como um balde e cada candidato da etiqueta como uma comparação
+    size_t localizarCom(const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+        unsigned long long espalhado = espalhar(hash);
+        int8_t alvo = etiqueta(espalhado);
+        size_t inicio = espalhado & mascara;
+
+        while (true) {
+            const int8_t* janela = controles.data() + inicio;
+            uint32_t candidatos = Sonda::iguais(janela, alvo);
+            instrumentacao.baldes(operacao, 1);
+            while (candidatos != 0) {
+                instrumentacao.comparacoes(operacao, 1);
+                size_t indice = (inicio + __builtin_ctz(candidatos)) & mascara;
+                if (hashes[indice] == hash && igual(chaves[indice], chave)) {
+                    return indice;
+                }
+                candidatos &= candidatos - 1;
+            }
+            // Uma posição vazia na janela encerra a sequência de sondagem
+            if (Sonda::vazios(janela) != 0) {
+                return capacidade;
+            }
+            inicio = (inicio + Sonda::LARGURA) & mascara;
+        }
+    }
+
+    template <typename Sonda>
+    size_t primeiroLivreCom(unsigned long long espalhado) const {
+        size_t inicio = espalhado & mascara;
+
+        while (true) {
+            uint32_t livres = Sonda::livres(controles.data() + inicio);
+            if (livres != 0) {
+                return (inicio + __builtin_ctz(livres)) & mascara;
+            }
+            inicio = (inicio + Sonda::LARGURA) & mascara;
+        }
+    }
+
+#ifdef HASH_X86
+    // Compiladas com AVX2 para que as sondas sejam expandidas dentro do laço
+    template <typename Consulta>
+    __attribute__((target("avx2"), flatten))
+    size_t localizarAvx2(const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+        return localizarCom<SondaAvx2>(chave, hash, operacao);
+    }
+
+    __attribute__((target("avx2"), flatten))
+    size_t primeiroLivreAvx2(unsigned long long espalhado) const {
+        return primeiroLivreCom<SondaAvx2>(espalhado);
+    }
+#endif
+
+    // Procura a posição da chave; devolve capacidade quando não existe
+    template <typename Consulta>
+    size_t localizar(const Consulta& chave, size_t hash, OperacaoTabela operacao) const {
+#ifdef HASH_X86
+        switch (nivel) {
+            case NivelSimd::AVX2: return localizarAvx2(chave, hash, operacao);
+            case NivelSimd::SSE2: return localizarCom<SondaSse2>(chave, hash, operacao);
+            default: break;
+        }
+#endif
+        return localizarCom<SondaEscalar>(chave, hash, operacao);
+    }
+
+    size_t primeiroLivre(unsigned long long espalhado) const {
+#ifdef HASH_X86
+        switch (nivel) {
+            case NivelSimd::AVX2: return primeiroLivreAvx2(espalhado);
+            case NivelSimd::SSE2: return primeiroLivreCom<SondaSse2>(espalhado);
+            default: break;
+        }
+#endif
+        return primeiroLivreCom<SondaEscalar>(espalhado);
+    }
+
+    // Insere uma chave que sabidamente não está na tabela
+    void posicionar(Chave chave, Valor valor, size_t hash) {
+        unsigned long long espalhado = espalhar(hash);
+        size_t indice = primeiroLivre(espalhado);
+
+        distancias.adicionar((indice - (espalhado & mascara)) & mascara);
+        if (controles[indice] == CONTROLE_APAGADO) {
+            apagados--;
+        }
+
+        definirControle(indice, etiqueta(espalhado));
+        chaves[indice] = move(chave);
+        valores[indice] = move(valor);
+        hashes[indice] = hash;
+        elementos++;
+    }
+
+    void alocar(size_t novaCapacidade) {
+        capacidade = novaCapacidade;
+        mascara = capacidade - 1;
+        controles.assign(capacidade + LARGURA_CLONE, CONTROLE_VAZIO);
+        chaves.assign(capacidade, Chave());
+        valores.assign(capacidade, Valor());
+        hashes.assign(capacidade, 0);
+        distancias.limpar();
+        elementos = 0;
+        apagados = 0;
+    }
+
+    // Também usada com a mesma capacidade, só para descartar as lápides. causa: a operação
+    // que pediu o redimensionamento (reservar conta como inserção)
+    void redimensionar(size_t novaCapacidade, OperacaoTabela causa) {
+        long long inicio = agoraNs();
+        Vetor<int8_t> controlesAntigos = move(controles);
+        Vetor<Chave> chavesAntigas = move(chaves);
+        Vetor<Valor> valoresAntigos = move(valores);
+        Vetor<size_t> hashesAntigos = move(hashes);
+        size_t capacidadeAntiga = capacidade;
+
+        alocar(novaCapacidade);
+
+        for (size_t i = 0; i < capacidadeAntiga; i++) {
+            if (controlesAntigos[i] >= 0) {
+                posicionar(move(chavesAntigas[i]), move(valoresAntigos[i]), hashesAntigos[i]);
+            }
+        }
+
+        redimensionamentos++;
+        eventos.push_back({inicio, agoraNs(), capacidadeAntiga, capacidade, elementos,
+                           controles.size() + capacidade * (sizeof(Chave) + sizeof(Valor) + sizeof(size_t))});
+        instrumentacao.alocacoes(causa, 4);  // os quatro vetores
+        instrumentacao.movidos(causa, elementos);
+    }
+
+public:
+    TabelaGruposSimd(size_t capacidadeInicial = 32, double maxCarga = 0.875, double minCarga = 0.2,
+                     NivelSimd nivelSimd = detectarNivelSimd())
+        : capacidade(0), mascara(0), elementos(0), apagados(0), redimensionamentos(0),
+          cargaMaxima(maxCarga), cargaMinima(minCarga), capacidadeReservada(0), nivel(nivelSimd) {
+        size_t inicial = CAPACIDADE_MINIMA;
+        while (inicial < capacidadeInicial) {
+            inicial *= 2;
+        }
+        alocar(inicial);
+    }
+
+    void inserir(Chave chave, Valor valor) {
+        instrumentacao.hash(OperacaoTabela::INSERCAO);
+        size_t hash = hasher(chave);
+        inserirComHash(move(chave), move(valor), hash);
+    }
+    
+    // hash = hasher(chave), já calculado por quem chama
+    void inserirComHash(Chave chave, Valor valor, size_t hash) {
+        instrumentacao.operacao(OperacaoTabela::INSERCAO);
+        size_t indice = localizar(chave, hash, OperacaoTabela::INSERCAO);
+        if (indice != capacidade) {
+            valores[indice] = move(valor);
+            return;
+        }
+
+        // Lápides também ocupam posição: o limite conta elementos + apagados. Se a
+        // maior parte forem lápides, reconstrói no mesmo tamanho em vez de dobrar
+        if ((double)(elementos + apagados + 1) / capacidade > cargaMaxima) {
+            if ((double)(elementos + 1) / capacidade > cargaMaxima / 2) {
+                redimensionar(capacidade * 2, OperacaoTabela::INSERCAO);
+            } else {
+                redimensionar(capacidade, OperacaoTabela::INSERCAO);
+            }
+        }
+
+        posicionar(move(chave), move(valor), hash);
+    }
+
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        instrumentacao.operacao(OperacaoTabela::BUSCA);
+        instrumentacao.hash(OperacaoTabela::BUSCA);
+        size_t indice = localizar(chave, hasher(chave), OperacaoTabela::BUSCA);
+        if (indice == capacidade) {
+            return false;
+        }
+        valorEncontrado = valores[indice];
+        return true;
+    }
+
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        instrumentacao.operacao(OperacaoTabela::REMOCAO);
+        instrumentacao.hash(OperacaoTabela::REMOCAO);
+        size_t indice = localizar(chave, hasher(chave), OperacaoTabela::REMOCAO);
+        if (indice == capacidade) {
+            return false;
+        }
+
+        distancias.retirar(distancia(hashes[indice], indice));
+        definirControle(indice, CONTROLE_APAGADO);
+        chaves[indice] = Chave();
+        apagados++;
+        elementos--;
+
+        if (capacidade > CAPACIDADE_MINIMA && capacidade > capacidadeReservada && obterFatorCarga() <= cargaMinima) {
+            redimensionar(capacidade / 2, OperacaoTabela::REMOCAO);
+        }
+
+        return true;
+    }
+
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima com no máximo um rehash; a
+    // tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        capacidadeReservada = CAPACIDADE_MINIMA;
+        while (capacidadeReservada < capacidadeParaCarga(n, cargaMaxima)) {
+            capacidadeReservada *= 2;
+        }
+        if (capacidadeReservada > capacidade) {
+            redimensionar(capacidadeReservada, OperacaoTabela::INSERCAO);
+        }
+    }
+    
+    // reservar para o total e inserções em sequência, sem nenhum rehash no caminho. Sem
+    // threads: a sondagem de um grupo pode atravessar qualquer fronteira entre faixas de posições
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned = 0) {
+        reservar(elementos + pares.size());
+        for (const auto& [chave, valor] : pares) {
+            inserir(chave, valor);
+        }
+    }
+    
+    // Pede a janela de controle e as posições de origem do lote inteiro antes de sondar
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        size_t hashesLote[LOTE_PRECARGA];
+        size_t achados = 0;
+        
+        for (size_t base = 0; base < quantidade; base += LOTE_PRECARGA) {
+            size_t tamanho = min(LOTE_PRECARGA, quantidade - base);
+            
+            for (size_t j = 0; j < tamanho; j++) {
+                instrumentacao.operacao(OperacaoTabela::BUSCA);
+                instrumentacao.hash(OperacaoTabela::BUSCA);
+                hashesLote[j] = hasher(consultas[base + j]);
+                size_t inicio = espalhar(hashesLote[j]) & mascara;
+                precarregar(&controles[inicio]);
+                precarregar(&hashes[inicio]);
+                precarregar(&chaves[inicio]);
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                size_t indice = localizar(consultas[base + j], hashesLote[j], OperacaoTabela::BUSCA);
+                encontrados[base + j] = indice != capacidade;
+                if (indice != capacidade) {
+                    resultados[base + j] = valores[indice];
+                    achados++;
+                }
+            }
+        }
+        return achados;
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        inserirLoteComPrecarga(chavesLote, valoresLote, quantidade, hasher,
+                               [&](size_t hash) { return &controles[espalhar(hash) & mascara]; },
+                               [&](const Chave& chave, const Valor& valor, size_t hash) {
+                                   inserirComHash(chave, valor, hash);
+                               });
+    }
+    
+    // visitar(chave, valor) para cada elemento, em ordem de posição
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        for (size_t i = 0; i < capacidade; i++) {
+            if (controles[i] >= 0) {
+                visitar(chaves[i], valores[i]);
+            }
+        }
+    }
+    
+    // Elementos fora da posição de origem
+    size_t obterColisoes() const { return elementos - distancias[0]; }
+    // Cadeia de um elemento: as janelas lidas até ele (a distância dividida pela largura
+    // da janela, mais um). Uma chave ausente para na primeira janela com posição vazia;
+    // a média é estimada supondo posições ocupadas (elementos e lápides) independentes
+    EstatisticasTabela obterEstatisticas() const {
+        EstatisticasTabela estatisticas;
+        estatisticas.elementos = elementos;
+        estatisticas.capacidade = capacidade;
+        estatisticas.baldesOcupados = elementos;
+        
+        size_t largura = larguraJanela();
+        double total = 0;
+        const vector<size_t>& porDistancia = distancias.obterContagens();
+        for (size_t d = 0; d < porDistancia.size(); d++) {
+            if (porDistancia[d] == 0) continue;
+            size_t janelas = d / largura + 1;
+            if (janelas >= estatisticas.histograma.size()) {
+                estatisticas.histograma.resize(janelas + 1, 0);
+            }
+            estatisticas.histograma[janelas] += porDistancia[d];
+            total += (double)janelas * porDistancia[d];
+        }
+        estatisticas.cadeiaMaxima = estatisticas.histograma.empty() ? 0 : estatisticas.histograma.size() - 1;
+        estatisticas.sondasAcerto = elementos > 0 ? total / elementos : 0.0;
+        
+        double cheia = pow((double)(elementos + apagados) / capacidade, (double)largura);
+        estatisticas.sondasFalha = 1.0 / max(1.0 - cheia, 1.0 / capacidade);
+        return estatisticas;
+    }
+    size_t obterCapacidade() const { return capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    const Instrumentacao& obterInstrumentacao() const { return instrumentacao; }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    NivelSimd obterNivelSimd() const { return nivel; }
+    double obterFatorCarga() const {
+        return capacidade > 0 ? (double)elementos / capacidade : 0.0;
+    }
+};
+
+// Tabela hash - FRAGMENTADA (CONCORRENTE)
+// Divide as chaves em fragmentos independentes, cada um com a sua tabela e o seu mutex.
+// Um redimensionamento bloqueia só o fragmento que cresceu; as outras threads seguem nos
+// demais. O fragmento sai dos bits altos do hash misturado (Fibonacci), que não se
+// repetem nos bits que as políticas usam para escolher o balde dentro do fragmento
+template <typename Chave = int, typename Valor = int, typename Fragmento = TabelaDuplicacao<Chave, Valor>,
+          typename Hasher = HashChave<Chave>>
+class TabelaFragmentada {
+private:
+    // Uma linha de cache por fragmento: os mutexes vizinhos não disputam a mesma linha
+    struct alignas(64) Parte {
+        mutable mutex trava;
+        Fragmento tabela;
+        
+        template <typename... Argumentos>
+        explicit Parte(const Argumentos&... argumentos) : tabela(argumentos...) {}
+    };
+    
+    vector<unique_ptr<Parte>> partes;
+    int bitsFragmento;
+    Hasher hasher;
+    
+    template <typename Consulta>
+    size_t indiceFragmento(const Consulta& chave) const {
+        if (bitsFragmento == 0) {
+            return 0;
+        }
+        uint64_t misturado = (uint64_t)hasher(chave) * 0x9E3779B97F4A7C15ULL;
+        return misturado >> (64 - bitsFragmento);
+    }
+    
+    template <typename Consulta>
+    Parte& parte(const Consulta& chave) {
+        return *partes[indiceFragmento(chave)];
+    }
+    
+    template <typename Funcao>
+    size_t somar(Funcao&& ler) const {
+        size_t soma = 0;
+        for (const auto& p : partes) {
+            lock_guard<mutex> guarda(p->trava);
+            soma += ler(p->tabela);
+        }
+        return soma;
+    }
+    
+public:
+    // fragmentos é arredondado para potência de 2; os demais argumentos vão para
+    // o construtor de cada fragmento
+    template <typename... Argumentos>
+    explicit TabelaFragmentada(size_t fragmentos, const Argumentos&... argumentos) : bitsFragmento(0) {
+        while (((size_t)1 << bitsFragmento) < fragmentos) {
+            bitsFragmento++;
+        }
+        for (size_t i = 0; i < ((size_t)1 << bitsFragmento); i++) {
+            partes.push_back(make_unique<Parte>(argumentos...));
+        }
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        Parte& p = parte(chave);
+        lock_guard<mutex> guarda(p.trava);
+        p.tabela.inserir(move(chave), move(valor));
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) {
+        Parte& p = parte(chave);
+        lock_guard<mutex> guarda(p.trava);
+        return p.tabela.buscar(chave, valorEncontrado);
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        Parte& p = parte(chave);
+        lock_guard<mutex> guarda(p.trava);
+        return p.tabela.remover(chave);
+    }
+    
+    // Cada fragmento reserva a sua parte; um fragmento com mais chaves que a média ainda
+    // pode crescer uma vez
+    void reservar(size_t n) {
+        for (auto& p : partes) {
+            lock_guard<mutex> guarda(p->trava);
+            p->tabela.reservar((n + partes.size() - 1) / partes.size());
+        }
+    }
+    
+    // Os fragmentos já são as faixas: os pares são separados por fragmento e cada thread
+    // constrói fragmentos inteiros, cada um com o seu próprio alocador
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned threads = 0) {
+        vector<vector<pair<Chave, Valor>>> porFragmento(partes.size());
+        for (const auto& par : pares) {
+            porFragmento[indiceFragmento(par.first)].push_back(par);
+        }
+        
+        unsigned usadas = min((unsigned)partes.size(), threadsConstrucao(threads, pares.size()));
+        executarEmParalelo(usadas, [&](unsigned t) {
+            for (size_t i = t; i < partes.size(); i += usadas) {
+                lock_guard<mutex> guarda(partes[i]->trava);
+                partes[i]->tabela.construirDe(porFragmento[i], 1);
+            }
+        });
+    }
+    
+    // Cada chave trava o seu fragmento; o lote só evita a chamada por chave de quem usa
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) {
+        size_t achados = 0;
+        for (size_t i = 0; i < quantidade; i++) {
+            encontrados[i] = buscar(consultas[i], resultados[i]);
+            achados += encontrados[i];
+        }
+        return achados;
+    }
+    
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        for (size_t i = 0; i < quantidade; i++) {
+            inserir(chavesLote[i], valoresLote[i]);
+        }
+    }
+    
+    // Fragmento a fragmento, cada um travado enquanto é visitado
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) {
+        for (auto& p : partes) {
+            lock_guard<mutex> guarda(p->trava);
+            p->tabela.paraCadaElemento(visitar);
+        }
+    }
+    
+    // Somas lidas fragmento a fragmento: com escritas em curso são apenas aproximadas
+    size_t obterColisoes() const { return somar([](const Fragmento& t) { return t.obterColisoes(); }); }
+    size_t obterCapacidade() const { return somar([](const Fragmento& t) { return t.obterCapacidade(); }); }
+    size_t obterElementos() const { return somar([](const Fragmento& t) { return t.obterElementos(); }); }
+    size_t obterRedimensionamentos() const {
+        return somar([](const Fragmento& t) { return t.obterRedimensionamentos(); });
+    }
+    size_t obterFragmentos() const { return partes.size(); }
+    
+    // Retratos dos fragmentos somados; uma chave ausente cai em qualquer fragmento com a
+    // mesma chance, então o custo de falha é a média simples entre eles
+    EstatisticasTabela obterEstatisticas() const {
+        EstatisticasTabela total;
+        double sondasAcerto = 0;
+        for (const auto& p : partes) {
+            EstatisticasTabela e;
+            {
+                lock_guard<mutex> guarda(p->trava);
+                e = p->tabela.obterEstatisticas();
+            }
+            total.elementos += e.elementos;
+            total.capacidade += e.capacidade;
+            total.baldesOcupados += e.baldesOcupados;
+            total.cadeiaMaxima = max(total.cadeiaMaxima, e.cadeiaMaxima);
+            if (total.histograma.size() < e.histograma.size()) {
+                total.histograma.resize(e.histograma.size(), 0);
+            }
+            for (size_t c = 0; c < e.histograma.size(); c++) {
+                total.histograma[c] += e.histograma[c];
+            }
+            sondasAcerto += e.sondasAcerto * e.elementos;
+            total.sondasFalha += e.sondasFalha / partes.size();
+        }
+        total.sondasAcerto = total.elementos > 0 ? sondasAcerto / total.elementos : 0.0;
+        return total;
+    }
+    
+    // Eventos de todos os fragmentos, em ordem de início
+    vector<EventoRedimensionamento> obterEventosRedimensionamento() const {
+        vector<EventoRedimensionamento> eventos;
+        for (const auto& p : partes) {
+            lock_guard<mutex> guarda(p->trava);
+            const auto& deste = p->tabela.obterEventosRedimensionamento();
+            eventos.insert(eventos.end(), deste.begin(), deste.end());
+        }
+        sort(eventos.begin(), eventos.end(),
+             [](const EventoRedimensionamento& a, const EventoRedimensionamento& b) { return a.inicioNs < b.inicioNs; });
+        return eventos;
+    }
+    
+    double obterFatorCarga() const {
+        size_t capacidade = obterCapacidade();
+        return capacidade > 0 ? (double)obterElementos() / capacidade : 0.0;
+    }
+};
+
+// RECLAMAÇÃO POR ÉPOCAS
+// Durante uma leitura, a thread anuncia a época global no seu próprio slot (uma linha de
+// cache por thread; 0 = fora de leitura), então ler não escreve em linha compartilhada.
+// Quem desliga um objeto o aposenta com a época do momento e avança a época global; o
+// objeto só é liberado quando todo leitor ativo anunciou uma época maior que a dele.
+// As cercas seq_cst dos dois lados garantem que, se o escritor não viu o anúncio, o
+// leitor vê o objeto já desligado.
+struct alignas(64) SlotEpoca {
+    atomic<uint64_t> epoca{0};
+    atomic<bool> ocupado{false};
+};
+
+class ReclamacaoEpocas {
+public:
+    static const int MAXIMO_THREADS = 256;
+    
+private:
+    using Slot = SlotEpoca;
+    
+    inline static atomic<uint64_t> epocaGlobal{1};
+    inline static Slot slots[MAXIMO_THREADS];
+    
+    // Slot da thread, devolvido quando ela termina
+    struct Registro {
+        int indice = -1;
+        ~Registro() {
+            if (indice >= 0) {
+                slots[indice].ocupado.store(false, memory_order_release);
+            }
+        }
+    };
+    
+    static Slot& slotDaThread() {
+        thread_local Registro registro;
+        if (registro.indice < 0) {
+            for (int i = 0; i < MAXIMO_THREADS && registro.indice < 0; i++) {
+                bool livre = false;
+                if (slots[i].ocupado.compare_exchange_strong(livre, true)) {
+                    registro.indice = i;
+                }
+            }
+            if (registro.indice < 0) {
+                throw runtime_error("threads demais para a reclamação por épocas");
+            }
+        }
+        return slots[registro.indice];
+    }
+    
+public:
+    // Guarda de uma leitura; não pode ser aninhada na mesma thread
+    class Leitura {
+    private:
+        Slot& slot;
+        
+    public:
+        Leitura() : slot(slotDaThread()) {
+            slot.epoca.store(epocaGlobal.load(memory_order_relaxed), memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+        }
+        ~Leitura() { slot.epoca.store(0, memory_order_release); }
+    };
+    
+    // Chamado depois de desligar o objeto; devolve a época da aposentadoria
+    static uint64_t aposentar() {
+        return epocaGlobal.fetch_add(1, memory_order_seq_cst);
+    }
+    
+    // Objetos aposentados com época menor que esta podem ser liberados
+    static uint64_t menorEpocaAtiva() {
+        atomic_thread_fence(memory_order_seq_cst);
+        uint64_t menor = UINT64_MAX;
+        for (const Slot& slot : slots) {
+            uint64_t epoca = slot.epoca.load(memory_order_acquire);
+            if (epoca != 0 && epoca < menor) {
+                menor = epoca;
+            }
+        }
+        return menor;
+    }
+};
+
+// Tabela hash - LEITURA SEM TRAVAS (RCU)
+// Encadeada, com o vetor de baldes publicado por um ponteiro atômico. buscar não trava
+// nada: anuncia a época e percorre nós imutáveis. Os escritores se revezam em um mutex;
+// atualizar troca o nó inteiro, remover religa o anterior, e o redimensionamento monta
+// um arranjo novo com cópias dos nós (os antigos seguem válidos para quem ainda os lê)
+// e o publica de uma vez. Arranjos e nós desligados esperam a reclamação por épocas.
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase>
+class TabelaRcu {
+private:
+    struct No {
+        Chave chave;
+        Valor valor;
+        size_t hash;
+        atomic<No*> proximo;
+        
+        No(Chave c, Valor v, size_t h, No* p) : chave(move(c)), valor(move(v)), hash(h), proximo(p) {}
+    };
+    
+    // Cabeçalho seguido dos baldes, em um único bloco
+    struct Arranjo {
+        size_t capacidade;
+        PoliticaHash politica;
+        
+        atomic<No*>* baldes() { return reinterpret_cast<atomic<No*>*>(this + 1); }
+    };
+    
+    struct Aposentado {
+        void* objeto;
+        void (*liberar)(void*);
+        uint64_t epoca;
+    };
+    
+    // Acima disso, cada aposentadoria tenta liberar os que nenhum leitor alcança mais
+    static const size_t LIMITE_APOSENTADOS = 128;
+    
+    atomic<Arranjo*> atual;
+    mutable mutex escrita;
+    vector<Aposentado> aposentados;
+    size_t elementos;
+    HistogramaComprimentos cadeias;  // baldes por comprimento da cadeia, dos escritores
+    size_t redimensionamentos;
+    vector<EventoRedimensionamento> eventos;
+    double cargaMaxima;
+    double cargaMinima;
+    size_t capacidadeReservada;
+    Hasher hasher;
+    Igual igual;
+    
+    static No* criarNo(Chave chave, Valor valor, size_t hash, No* proximo) {
+        return new (MedidorMemoria::alocar(sizeof(No))) No(move(chave), move(valor), hash, proximo);
+    }
+    
+    static void liberarNo(void* objeto) {
+        No* no = static_cast<No*>(objeto);
+        no->~No();
+        MedidorMemoria::liberar(no, sizeof(No));
+    }
+    
+    static Arranjo* criarArranjo(size_t capacidade) {
+        void* bloco = MedidorMemoria::alocar(sizeof(Arranjo) + capacidade * sizeof(atomic<No*>));
+        Arranjo* arranjo = new (bloco) Arranjo();
+        arranjo->capacidade = capacidade;
+        arranjo->politica.ajustar(capacidade);
+        for (size_t i = 0; i < capacidade; i++) {
+            new (&arranjo->baldes()[i]) atomic<No*>(nullptr);
+        }
+        return arranjo;
+    }
+    
+    // Libera o arranjo e os nós ainda ligados a ele
+    static void liberarArranjo(void* objeto) {
+        Arranjo* arranjo = static_cast<Arranjo*>(objeto);
+        for (size_t i = 0; i < arranjo->capacidade; i++) {
+            No* no = arranjo->baldes()[i].load(memory_order_relaxed);
+            while (no != nullptr) {
+                No* proximo = no->proximo.load(memory_order_relaxed);
+                liberarNo(no);
+                no = proximo;
+            }
+        }
+        size_t bytes = sizeof(Arranjo) + arranjo->capacidade * sizeof(atomic<No*>);
+        arranjo->~Arranjo();
+        MedidorMemoria::liberar(arranjo, bytes);
+    }
+    
+    void aposentar(void* objeto, void (*liberar)(void*)) {
+        aposentados.push_back({objeto, liberar, ReclamacaoEpocas::aposentar()});
+        if (aposentados.size() >= LIMITE_APOSENTADOS) {
+            reclamar();
+        }
+    }
+    
+    // As épocas crescem na ordem da lista, então os liberáveis formam um prefixo
+    void reclamar() {
+        uint64_t menor = ReclamacaoEpocas::menorEpocaAtiva();
+        size_t liberados = 0;
+        while (liberados < aposentados.size() && aposentados[liberados].epoca < menor) {
+            aposentados[liberados].liberar(aposentados[liberados].objeto);
+            liberados++;
+        }
+        aposentados.erase(aposentados.begin(), aposentados.begin() + liberados);
+    }
+    
+    void redimensionar(size_t novaCapacidade) {
+        long long inicio = agoraNs();
+        Arranjo* antigo = atual.load(memory_order_relaxed);
+        Arranjo* novo = criarArranjo(PoliticaHash::capacidadeValida(novaCapacidade));
+        vector<uint32_t, AlocadorContado<uint32_t>> comprimentos(novo->capacidade, 0);
+        
+        for (size_t i = 0; i < antigo->capacidade; i++) {
+            for (No* no = antigo->baldes()[i].load(memory_order_relaxed); no != nullptr;
+                 no = no->proximo.load(memory_order_relaxed)) {
+                size_t indice = novo->politica.indice(no->hash);
+                atomic<No*>& balde = novo->baldes()[indice];
+                No* cabeca = balde.load(memory_order_relaxed);
+                balde.store(criarNo(no->chave, no->valor, no->hash, cabeca), memory_order_relaxed);
+                comprimentos[indice]++;
+            }
+        }
+        cadeias.limpar();
+        for (uint32_t comprimento : comprimentos) {
+            cadeias.adicionar(comprimento);
+        }
+        
+        // aposentar pode liberar o arranjo antigo na hora
+        size_t capacidadeAnterior = antigo->capacidade;
+        atual.store(novo, memory_order_release);
+        aposentar(antigo, liberarArranjo);
+        redimensionamentos++;
+        eventos.push_back({inicio, agoraNs(), capacidadeAnterior, novo->capacidade, elementos,
+                           novo->capacidade * sizeof(atomic<No*>) + elementos * sizeof(No)});
+    }
+    
+    double fatorCarga() const {
+        return (double)elementos / atual.load(memory_order_relaxed)->capacidade;
+    }
+    
+public:
+    TabelaRcu(size_t capacidadeInicial = 8, double maxCarga = 0.7, double minCarga = 0.2)
+        : atual(criarArranjo(PoliticaHash::capacidadeValida(capacidadeInicial))), elementos(0),
+          redimensionamentos(0), cargaMaxima(maxCarga), cargaMinima(minCarga), capacidadeReservada(0) {
+        cadeias.adicionar(0, atual.load(memory_order_relaxed)->capacidade);
+    }
+    
+    TabelaRcu(const TabelaRcu&) = delete;
+    TabelaRcu& operator=(const TabelaRcu&) = delete;
+    
+    // Nenhum leitor pode estar dentro da tabela
+    ~TabelaRcu() {
+        for (const Aposentado& aposentado : aposentados) {
+            aposentado.liberar(aposentado.objeto);
+        }
+        liberarArranjo(atual.load(memory_order_relaxed));
+    }
+    
+    void inserir(Chave chave, Valor valor) {
+        lock_guard<mutex> guarda(escrita);
+        size_t hash = hasher(chave);
+        
+        if (fatorCarga() >= cargaMaxima) {
+            redimensionar(atual.load(memory_order_relaxed)->capacidade * 2);
+        }
+        
+        Arranjo* arranjo = atual.load(memory_order_relaxed);
+        atomic<No*>& balde = arranjo->baldes()[arranjo->politica.indice(hash)];
+        
+        atomic<No*>* ligacao = &balde;
+        size_t comprimento = 0;
+        for (No* no = balde.load(memory_order_relaxed); no != nullptr; no = no->proximo.load(memory_order_relaxed)) {
+            if (no->hash == hash && igual(no->chave, chave)) {
+                ligacao->store(criarNo(move(chave), move(valor), hash, no->proximo.load(memory_order_relaxed)),
+                               memory_order_release);
+                aposentar(no, liberarNo);
+                return;
+            }
+            ligacao = &no->proximo;
+            comprimento++;
+        }
+        
+        No* cabeca = balde.load(memory_order_relaxed);
+        cadeias.mudar(comprimento, comprimento + 1);
+        balde.store(criarNo(move(chave), move(valor), hash, cabeca), memory_order_release);
+        elementos++;
+    }
+    
+    // Sem travas e sem escrita compartilhada; pode rodar junto com qualquer escritor
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) const {
+        size_t hash = hasher(chave);
+        ReclamacaoEpocas::Leitura leitura;
+        Arranjo* arranjo = atual.load(memory_order_acquire);
+        
+        for (No* no = arranjo->baldes()[arranjo->politica.indice(hash)].load(memory_order_acquire); no != nullptr;
+             no = no->proximo.load(memory_order_acquire)) {
+            if (no->hash == hash && igual(no->chave, chave)) {
+                valorEncontrado = no->valor;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Uma única leitura anunciada para o lote; baldes e primeiros nós pedidos antes de comparar
+    template <typename Consulta>
+    size_t buscarLote(const Consulta* consultas, size_t quantidade, Valor* resultados, bool* encontrados) const {
+        size_t hashes[LOTE_PRECARGA];
+        No* primeiros[LOTE_PRECARGA];
+        size_t achados = 0;
+        ReclamacaoEpocas::Leitura leitura;
+        Arranjo* arranjo = atual.load(memory_order_acquire);
+        
+        for (size_t base = 0; base < quantidade; base += LOTE_PRECARGA) {
+            size_t tamanho = min(LOTE_PRECARGA, quantidade - base);
+            
+            for (size_t j = 0; j < tamanho; j++) {
+                hashes[j] = hasher(consultas[base + j]);
+                precarregar(&arranjo->baldes()[arranjo->politica.indice(hashes[j])]);
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                primeiros[j] = arranjo->baldes()[arranjo->politica.indice(hashes[j])].load(memory_order_acquire);
+                if (primeiros[j] != nullptr) {
+                    precarregar(primeiros[j]);
+                }
+            }
+            for (size_t j = 0; j < tamanho; j++) {
+                encontrados[base + j] = false;
+                for (No* no = primeiros[j]; no != nullptr; no = no->proximo.load(memory_order_acquire)) {
+                    if (no->hash == hashes[j] && igual(no->chave, consultas[base + j])) {
+                        resultados[base + j] = no->valor;
+                        encontrados[base + j] = true;
+                        achados++;
+                        break;
+                    }
+                }
+            }
+        }
+        return achados;
+    }
+    
+    // Pré-dimensiona para n elementos abaixo de cargaMaxima com no máximo um rehash; a
+    // tabela não encolhe mais abaixo dessa capacidade (reservar(0) desfaz o piso)
+    void reservar(size_t n) {
+        lock_guard<mutex> guarda(escrita);
+        capacidadeReservada = PoliticaHash::capacidadeValida(capacidadeParaCarga(n, cargaMaxima));
+        if (capacidadeReservada > atual.load(memory_order_relaxed)->capacidade) {
+            redimensionar(capacidadeReservada);
+        }
+    }
+    
+    // reservar para o total e inserções em sequência: os leitores podem estar no arranjo
+    // publicado, então os baldes não são preenchidos em paralelo por fora do mutex
+    void construirDe(const vector<pair<Chave, Valor>>& pares, unsigned = 0) {
+        reservar(elementos + pares.size());
+        for (const auto& [chave, valor] : pares) {
+            inserir(chave, valor);
+        }
+    }
+    
+    // Cada inserção toma o mutex dos escritores, como inserir
+    void inserirLote(const Chave* chavesLote, const Valor* valoresLote, size_t quantidade) {
+        for (size_t i = 0; i < quantidade; i++) {
+            inserir(chavesLote[i], valoresLote[i]);
+        }
+    }
+    
+    template <typename Consulta>
+    bool remover(const Consulta& chave) {
+        lock_guard<mutex> guarda(escrita);
+        size_t hash = hasher(chave);
+        Arranjo* arranjo = atual.load(memory_order_relaxed);
+        
+        atomic<No*>* ligacao = &arranjo->baldes()[arranjo->politica.indice(hash)];
+        size_t comprimento = 1;  // até o nó removido; o resto é contado ao achá-lo
+        for (No* no = ligacao->load(memory_order_relaxed); no != nullptr; no = no->proximo.load(memory_order_relaxed)) {
+            if (no->hash == hash && igual(no->chave, chave)) {
+                for (No* resto = no->proximo.load(memory_order_relaxed); resto != nullptr;
+                     resto = resto->proximo.load(memory_order_relaxed)) {
+                    comprimento++;
+                }
+                cadeias.mudar(comprimento, comprimento - 1);
+                ligacao->store(no->proximo.load(memory_order_relaxed), memory_order_release);
+                aposentar(no, liberarNo);
+                elementos--;
+                
+                if (arranjo->capacidade > 8 && arranjo->capacidade > capacidadeReservada && fatorCarga() <= cargaMinima) {
+                    redimensionar(arranjo->capacidade / 2);
+                }
+                return true;
+            }
+            ligacao = &no->proximo;
+            comprimento++;
+        }
+        return false;
+    }
+    
+    // Percorre o arranjo publicado como um leitor; com escritas em curso, cada elemento
+    // estável é visitado uma vez e os que entram ou saem podem ou não aparecer
+    template <typename Visitante>
+    void paraCadaElemento(Visitante&& visitar) const {
+        ReclamacaoEpocas::Leitura leitura;
+        Arranjo* arranjo = atual.load(memory_order_acquire);
+        for (size_t i = 0; i < arranjo->capacidade; i++) {
+            for (No* no = arranjo->baldes()[i].load(memory_order_acquire); no != nullptr;
+                 no = no->proximo.load(memory_order_acquire)) {
+                visitar(no->chave, no->valor);
+            }
+        }
+    }
+    
+    // As cadeias são lidas com o mutex dos escritores; os leitores não são afetados
+    size_t obterColisoes() const {
+        lock_guard<mutex> guarda(escrita);
+        return elementos - (cadeias.obterTotal() - cadeias[0]);
+    }
+    EstatisticasTabela obterEstatisticas() const {
+        lock_guard<mutex> guarda(escrita);
+        return estatisticasEncadeadas(cadeias, elementos);
+    }
+    
+    // Contadores dos escritores: leia com a tabela parada ou aceite um valor aproximado
+    size_t obterCapacidade() const { return atual.load(memory_order_acquire)->capacidade; }
+    size_t obterElementos() const { return elementos; }
+    size_t obterRedimensionamentos() const { return redimensionamentos; }
+    size_t obterAposentados() const { return aposentados.size(); }
+    const vector<EventoRedimensionamento>& obterEventosRedimensionamento() const { return eventos; }
+    double obterFatorCarga() const { return (double)elementos / obterCapacidade(); }
+};
+
+// INSTANTÂNEO EM ARQUIVO MAPEADO
+// Formato: o cabeçalho, capacidade + 1 inícios de balde (o balde i ocupa os registros
+// [inicios[i], inicios[i + 1])) e os registros chave/valor agrupados por balde. A imagem
+// é montada na memória e gravada com uma única escrita sequencial; a leitura mapeia o
+// arquivo com mmap e as buscas leem direto dele, sem desserializar: o sistema só traz
+// do disco as páginas que elas tocam. Sem folga para crescer, a capacidade é o número de
+// elementos (fator de carga 1)
+const char ASSINATURA_INSTANTANEO[8] = {'H', 'I', 'N', 'S', 'T', '0', '0', '1'};
+
+struct CabecalhoInstantaneo {
+    char assinatura[8];
+    char estrategia[24];       // estratégia que gravou, só informativo
+    uint64_t capacidade;
+    uint64_t elementos;
+    uint64_t verificacaoHash;  // baldes de chaves fixas: muda se o hasher ou a política mudar
+    uint32_t bytesChave;
+    uint32_t bytesValor;
+};
+
+template <typename Chave = int, typename Valor = int, typename Hasher = HashChave<Chave>,
+          typename Igual = equal_to<>, typename PoliticaHash = HashBase>
+class TabelaMapeada {
+    static_assert(is_integral<Chave>::value && is_trivially_copyable<Valor>::value,
+                  "o instantâneo grava chaves e valores byte a byte");
+    
+private:
+    struct Registro {
+        Chave chave;
+        Valor valor;
+    };
+    
+    const char* base;
+    size_t bytes;
+    vector<char> copia;  // sem mmap, o arquivo lido inteiro
+    const CabecalhoInstantaneo* cabecalho;
+    const uint64_t* inicios;
+    const Registro* registros;
+    PoliticaHash politica;
+    Hasher hasher;
+    Igual igual;
+    
+    static uint64_t verificacao(const PoliticaHash& politica, const Hasher& hasher) {
+        uint64_t soma = 0;
+        for (int i = 0; i < 16; i++) {
+            soma = soma * 1000003 + politica.indice(hasher((Chave)(i * 7919)));
+        }
+        return soma;
+    }
+    
+    // Confere o que o cabeçalho promete contra o tamanho do arquivo e os tipos e o hash
+    // de quem abre; um instantâneo gravado com outro hasher acharia baldes errados. Os
+    // inícios dos baldes também: buscar confia neles para indexar os registros
+    bool validar() {
+        if (bytes < sizeof(CabecalhoInstantaneo)) return false;
+        cabecalho = reinterpret_cast<const CabecalhoInstantaneo*>(base);
+        if (!equal(cabecalho->assinatura, cabecalho->assinatura + sizeof(ASSINATURA_INSTANTANEO),
+                   ASSINATURA_INSTANTANEO) ||
+            cabecalho->bytesChave != sizeof(Chave) || cabecalho->bytesValor != sizeof(Valor) ||
+            cabecalho->capacidade == 0) {
+            return false;
+        }
+        // Limitados pelo tamanho do arquivo antes da conta, que senão pode transbordar
+        uint64_t corpo = bytes - sizeof(CabecalhoInstantaneo);
+        if (cabecalho->capacidade >= corpo / sizeof(uint64_t) || cabecalho->elementos > corpo / sizeof(Registro)) {
+            return false;
+        }
+        uint64_t esperados = sizeof(CabecalhoInstantaneo) + (cabecalho->capacidade + 1) * sizeof(uint64_t) +
+                             cabecalho->elementos * sizeof(Registro);
+        if (bytes != esperados) return false;
+        
+        politica.ajustar(cabecalho->capacidade);
+        if (verificacao(politica, hasher) != cabecalho->verificacaoHash) return false;
+        
+        inicios = reinterpret_cast<const uint64_t*>(base + sizeof(CabecalhoInstantaneo));
+        registros = reinterpret_cast<const Registro*>(inicios + cabecalho->capacidade + 1);
+        if (inicios[0] != 0 || inicios[cabecalho->capacidade] != cabecalho->elementos) return false;
+        for (uint64_t i = 0; i < cabecalho->capacidade; i++) {
+            if (inicios[i + 1] < inicios[i]) return false;
+        }
+        return true;
+    }
+    
+public:
+    TabelaMapeada() : base(nullptr), bytes(0), cabecalho(nullptr), inicios(nullptr), registros(nullptr) {}
+    
+    TabelaMapeada(const TabelaMapeada&) = delete;
+    TabelaMapeada& operator=(const TabelaMapeada&) = delete;
+    
+    ~TabelaMapeada() { fechar(); }
+    
+    // Grava os elementos de qualquer tabela com paraCadaElemento; falso se a escrita falhar
+    template <typename Tabela>
+    static bool gravar(Tabela& tabela, const string& estrategia, const string& arquivo) {
+        size_t elementos = tabela.obterElementos();
+        CabecalhoInstantaneo cabecalho = {};
+        copy(ASSINATURA_INSTANTANEO, ASSINATURA_INSTANTANEO + sizeof(ASSINATURA_INSTANTANEO), cabecalho.assinatura);
+        estrategia.copy(cabecalho.estrategia, sizeof(cabecalho.estrategia) - 1);
+        cabecalho.capacidade = PoliticaHash::capacidadeValida(max(elementos, (size_t)1));
+        cabecalho.elementos = elementos;
+        cabecalho.bytesChave = sizeof(Chave);
+        cabecalho.bytesValor = sizeof(Valor);
+        
+        PoliticaHash politica;
+        Hasher hasher;
+        politica.ajustar(cabecalho.capacidade);
+        cabecalho.verificacaoHash = verificacao(politica, hasher);
+        
+        size_t capacidade = cabecalho.capacidade;
+        vector<char, AlocadorContado<char>> imagem(sizeof(CabecalhoInstantaneo) + (capacidade + 1) * sizeof(uint64_t) +
+                                                   elementos * sizeof(Registro));
+        uint64_t* inicios = reinterpret_cast<uint64_t*>(imagem.data() + sizeof(CabecalhoInstantaneo));
+        Registro* registros = reinterpret_cast<Registro*>(inicios + capacidade + 1);
+        
+        // Ordenação por contagem: tamanho de cada balde em inicios[i + 1], somas de prefixo,
+        // e cada registro no próximo lugar livre do seu balde. Depois disso inicios[i] é o
+        // fim do balde i, e deslocar o vetor uma posição devolve os inícios
+        size_t visitados = 0;
+        tabela.paraCadaElemento([&](const Chave& chave, const Valor&) {
+            inicios[politica.indice(hasher(chave)) + 1]++;
+            visitados++;
+        });
+        if (visitados != elementos) return false;
+        for (size_t i = 0; i < capacidade; i++) {
+            inicios[i + 1] += inicios[i];
+        }
+        tabela.paraCadaElemento([&](const Chave& chave, const Valor& valor) {
+            registros[inicios[politica.indice(hasher(chave))]++] = {chave, valor};
+        });
+        for (size_t i = capacidade; i > 0; i--) {
+            inicios[i] = inicios[i - 1];
+        }
+        inicios[0] = 0;
+        copy(reinterpret_cast<const char*>(&cabecalho), reinterpret_cast<const char*>(&cabecalho + 1), imagem.begin());
+        
+        ofstream saida(arquivo, ios::binary);
+        saida.write(imagem.data(), imagem.size());
+        return (bool)saida;
+    }
+    
+    // Falso se o arquivo não existe, não é um instantâneo, está truncado ou foi gravado
+    // com outros tipos, hasher ou política
+    bool abrir(const string& arquivo) {
+        fechar();
+#if defined(HASH_MMAP)
+        int descritor = open(arquivo.c_str(), O_RDONLY);
+        if (descritor < 0) return false;
+        struct stat info;
+        if (fstat(descritor, &info) != 0 || info.st_size == 0) {
+            close(descritor);
+            return false;
+        }
+        void* mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+        close(descritor);
+        if (mapa == MAP_FAILED) return false;
+        // Buscas caem em páginas aleatórias: ler as vizinhas antecipadamente só desperdiça
+        madvise(mapa, info.st_size, MADV_RANDOM);
+        base = static_cast<const char*>(mapa);
+        bytes = info.st_size;
+#else
+        ifstream entrada(arquivo, ios::binary);
+        copia.assign(istreambuf_iterator<char>(entrada), istreambuf_iterator<char>());
+        base = copia.data();
+        bytes = copia.size();
+#endif
+        if (!validar()) {
+            fechar();
+            return false;
+        }
+        return true;
+    }
+    
+    void fechar() {
+#if defined(HASH_MMAP)
+        if (base != nullptr) {
+            munmap(const_cast<char*>(base), bytes);
+        }
+#else
+        copia.clear();
+#endif
+        base = nullptr;
+        bytes = 0;
+        cabecalho = nullptr;
+    }
+    
+    template <typename Consulta>
+    bool buscar(const Consulta& chave, Valor& valorEncontrado) const {
+        size_t indice = politica.indice(hasher(chave));
+        for (uint64_t r = inicios[indice]; r < inicios[indice + 1]; r++) {
+            if (igual(registros[r].chave, chave)) {
+                valorEncontrado = registros[r].valor;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool aberta() const { return cabecalho != nullptr; }
+    string obterEstrategia() const { return string(cabecalho->estrategia); }
+    size_t obterCapacidade() const { return cabecalho->capacidade; }
+    size_t obterElementos() const { return cabecalho->elementos; }
+    size_t obterBytes() const { return bytes; }
+    double obterFatorCarga() const { return (double)obterElementos() / obterCapacidade(); }
+};
+
+// Funções auxiliares para gerar os dados
+vector<int> gerarNumerosSequenciais(int quantidade) {
+    vector<int> numeros(quantidade);
+    for (int i = 0; i < quantidade; i++) {
+        numeros[i] = i;
+    }
+    return numeros;
+}
+
+vector<int> gerarNumerosAleatorios(int quantidade, uint64_t semente, int maximo = 1000000) {
+    vector<int> numeros(quantidade);
+    mt19937_64 gerador(semente);
+    uniform_int_distribution<> distribuicao(0, maximo);
+
+    for (int i = 0; i < quantidade; i++) {
+        numeros[i] = distribuicao(gerador);
+    }
+    return numeros;
+}
+
+// Chaves dos testes a partir dos números gerados, para repetir cada teste com outro
+// tipo de chave. consulta() é a forma usada nas buscas: texto busca por string_view,
+// sem construir std::string
+template <typename Chave>
+struct FabricaChave {
+    static string nome() { return "INTEIRAS"; }
+    static Chave criar(int numero) { return numero; }
+    static const Chave& consulta(const Chave& chave) { return chave; }
+};
+
+template <>
+struct FabricaChave<string> {
+    static string nome() { return "TEXTO"; }
+    static string criar(int numero) { return "chave:" + to_string(numero); }
+    static string_view consulta(const string& chave) { return chave; }
+};
+
+template <typename Chave>
+vector<Chave> gerarChaves(const vector<int>& numeros) {
+    vector<Chave> chaves;
+    chaves.reserve(numeros.size());
+    for (int numero : numeros) {
+        chaves.push_back(FabricaChave<Chave>::criar(numero));
+    }
+    return chaves;
+}
+
+// CARGAS DE TRABALHO
+// Sequências de operações no estilo YCSB, geradas antes da medição para que o custo
+// do gerador fique fora do tempo e todas as estratégias recebam a mesma sequência.
+// As chaves são identificadores 0..universo-1; os registros iniciais são 0..registros-1
+// e cada inserção da carga usa o próximo identificador livre.
+enum class TipoOperacao : uint8_t { BUSCAR, ATUALIZAR, INSERIR, REMOVER, LER_MODIFICAR_ESCREVER, VARREDURA };
+
+// 8 bytes, gravado como está no arquivo de traço (little-endian)
+struct Operacao {
+    uint32_t chave;
+    uint16_t comprimento;  // chaves consecutivas lidas pela varredura
+    uint8_t tipo;
+    uint8_t reservado;
+};
+static_assert(sizeof(Operacao) == 8, "formato do traço");
+
+enum class Distribuicao { UNIFORME, ZIPF, HOTSPOT, RECENTES };
+
+string nomeDistribuicao(Distribuicao distribuicao) {
+    switch (distribuicao) {
+        case Distribuicao::UNIFORME: return "uniforme";
+        case Distribuicao::ZIPF: return "zipf";
+        case Distribuicao::HOTSPOT: return "hotspot";
+        case Distribuicao::RECENTES: return "recentes";
+    }
+    return "";
+}
+
+bool lerDistribuicao(const string& nome, Distribuicao& distribuicao) {
+    for (Distribuicao d : {Distribuicao::UNIFORME, Distribuicao::ZIPF, Distribuicao::HOTSPOT, Distribuicao::RECENTES}) {
+        if (nomeDistribuicao(d) == nome) {
+            distribuicao = d;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Proporção de cada operação (soma 1) e distribuição das chaves lidas/alteradas
+struct MisturaOperacoes {
+    string nome;
+    double buscas;
+    double atualizacoes;
+    double insercoes;
+    double remocoes;
+    double lerModificarEscrever;
+    double varreduras;
+    Distribuicao distribuicao;
+};
+
+// YCSB A-F com as distribuições do próprio YCSB, mais R: remoções em massa, que
+// encolhem a tabela. Na E a varredura vira leituras pontuais de chaves consecutivas,
+// já que tabela hash não tem ordem
+const vector<MisturaOperacoes> MISTURAS_YCSB = {
+    {"A", 0.50, 0.50, 0.00, 0.00, 0.00, 0.00, Distribuicao::ZIPF},
+    {"B", 0.95, 0.05, 0.00, 0.00, 0.00, 0.00, Distribuicao::ZIPF},
+    {"C", 1.00, 0.00, 0.00, 0.00, 0.00, 0.00, Distribuicao::ZIPF},
+    {"D", 0.95, 0.00, 0.05, 0.00, 0.00, 0.00, Distribuicao::RECENTES},
+    {"E", 0.00, 0.00, 0.05, 0.00, 0.00, 0.95, Distribuicao::ZIPF},
+    {"F", 0.50, 0.00, 0.00, 0.00, 0.50, 0.00, Distribuicao::ZIPF},
+    {"R", 0.10, 0.00, 0.10, 0.80, 0.00, 0.00, Distribuicao::UNIFORME}
+};
+
+// Zipf de Gray et al. (o ZipfianGenerator do YCSB): O(n) para a constante zeta e O(1)
+// por amostra. Posição 0 é a mais popular
+class GeradorZipf {
+private:
+    size_t quantidade;
+    double teta;
+    double alfa;
+    double zetaN;
+    double eta;
+    double meioElevado;
+    
+    static double zeta(size_t n, double teta) {
+        double soma = 0;
+        for (size_t i = 1; i <= n; i++) {
+            soma += 1.0 / pow((double)i, teta);
+        }
+        return soma;
+    }
+    
+public:
+    GeradorZipf(size_t n, double constante = 0.99) : quantidade(n), teta(constante) {
+        alfa = 1.0 / (1.0 - teta);
+        zetaN = zeta(n, teta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - teta)) / (1.0 - zeta(2, teta) / zetaN);
+        meioElevado = 1.0 + pow(0.5, teta);
+    }
+    
+    template <typename Gerador>
+    size_t operator()(Gerador& gerador) {
+        double u = uniform_real_distribution<>(0.0, 1.0)(gerador);
+        double uz = u * zetaN;
+        if (uz < 1.0) return 0;
+        if (uz < meioElevado) return min((size_t)1, quantidade - 1);
+        return min((size_t)(quantidade * pow(eta * u - eta + 1.0, alfa)), quantidade - 1);
+    }
+};
+
+// Espalha a posição do Zipf (FNV-1a), como o ScrambledZipfian do YCSB: as chaves
+// quentes não ficam todas juntas no início do universo
+size_t espalharPosicao(size_t posicao, size_t quantidade) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < 8; i++) {
+        hash ^= (posicao >> (i * 8)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+    return hash % quantidade;
+}
+
+struct Carga {
+    string nome;
+    size_t registros;  // chaves inseridas antes das operações
+    vector<Operacao> operacoes;
+    
+    // Total de chaves distintas que a carga pode tocar
+    size_t universo() const {
+        size_t maior = registros;
+        for (const Operacao& operacao : operacoes) {
+            maior = max(maior, (size_t)operacao.chave + max((size_t)operacao.comprimento, (size_t)1));
+        }
+        return maior;
+    }
+};
+
+// Hotspot: 20% das chaves recebem 80% dos acessos
+const double HOTSPOT_FRACAO_CHAVES = 0.2;
+const double HOTSPOT_FRACAO_ACESSOS = 0.8;
+const int VARREDURA_MAXIMA = 100;
+
+Carga gerarCarga(const MisturaOperacoes& mistura, Distribuicao distribuicao, size_t registros,
+                 size_t quantidade, uint64_t semente) {
+    Carga carga;
+    carga.nome = mistura.nome;
+    carga.registros = registros;
+    carga.operacoes.reserve(quantidade);
+    
+    mt19937_64 gerador(semente);
+    uniform_real_distribution<> sorteio(0.0, 1.0);
+    GeradorZipf zipf(registros);
+    uint32_t proximaChave = registros;
+    
+    auto escolherChave = [&]() -> uint32_t {
+        size_t existentes = proximaChave;
+        switch (distribuicao) {
+            case Distribuicao::ZIPF:
+                return espalharPosicao(zipf(gerador), registros);
+            case Distribuicao::RECENTES: {
+                // As inseridas por último são as mais lidas
+                size_t posicao = zipf(gerador);
+                return existentes - 1 - min(posicao, existentes - 1);
+            }
+            case Distribuicao::HOTSPOT: {
+                size_t quentes = max((size_t)1, (size_t)(existentes * HOTSPOT_FRACAO_CHAVES));
+                if (sorteio(gerador) < HOTSPOT_FRACAO_ACESSOS || quentes == existentes) {
+                    return uniform_int_distribution<size_t>(0, quentes - 1)(gerador);
+                }
+                return uniform_int_distribution<size_t>(quentes, existentes - 1)(gerador);
+            }
+            default:
+                return uniform_int_distribution<size_t>(0, existentes - 1)(gerador);
+        }
+    };
+    
+    for (size_t i = 0; i < quantidade; i++) {
+        double r = sorteio(gerador);
+        Operacao operacao = {0, 0, 0, 0};
+        
+        if ((r -= mistura.buscas) < 0) {
+            operacao.tipo = (uint8_t)TipoOperacao::BUSCAR;
+            operacao.chave = escolherChave();
+        } else if ((r -= mistura.atualizacoes) < 0) {
+            operacao.tipo = (uint8_t)TipoOperacao::ATUALIZAR;
+            operacao.chave = escolherChave();
+        } else if ((r -= mistura.insercoes) < 0) {
+            operacao.tipo = (uint8_t)TipoOperacao::INSERIR;
+            operacao.chave = proximaChave++;
+        } else if ((r -= mistura.remocoes) < 0) {
+            operacao.tipo = (uint8_t)TipoOperacao::REMOVER;
+            operacao.chave = escolherChave();
+        } else if ((r -= mistura.lerModificarEscrever) < 0) {
+            operacao.tipo = (uint8_t)TipoOperacao::LER_MODIFICAR_ESCREVER;
+            operacao.chave = escolherChave();
+        } else {
+            operacao.tipo = (uint8_t)TipoOperacao::VARREDURA;
+            operacao.chave = escolherChave();
+            operacao.comprimento = uniform_int_distribution<>(1, VARREDURA_MAXIMA)(gerador);
+        }
+        carga.operacoes.push_back(operacao);
+    }
+    return carga;
+}
+
+// TRAÇO EM ARQUIVO
+// Cabeçalho: "HTRACO01", registros e quantidade de operações (uint64); depois as
+// operações de 8 bytes. Reproduzir o traço repete exatamente a mesma carga
+const char ASSINATURA_TRACO[8] = {'H', 'T', 'R', 'A', 'C', 'O', '0', '1'};
+
+bool gravarTraco(const string& arquivo, const Carga& carga) {
+    ofstream saida(arquivo, ios::binary);
+    uint64_t registros = carga.registros;
+    uint64_t quantidade = carga.operacoes.size();
+    saida.write(ASSINATURA_TRACO, sizeof(ASSINATURA_TRACO));
+    saida.write(reinterpret_cast<const char*>(&registros), sizeof(registros));
+    saida.write(reinterpret_cast<const char*>(&quantidade), sizeof(quantidade));
+    saida.write(reinterpret_cast<const char*>(carga.operacoes.data()), quantidade * sizeof(Operacao));
+    return (bool)saida;
+}
+
+// Devolve falso se o arquivo não existe, não é um traço ou está truncado. A quantidade do
+// cabeçalho só é usada depois de conferida com o tamanho do arquivo
+bool lerTraco(const string& arquivo, Carga& carga) {
+    ifstream entrada(arquivo, ios::binary);
+    char assinatura[sizeof(ASSINATURA_TRACO)];
+    uint64_t registros = 0;
+    uint64_t quantidade = 0;
+    
+    entrada.read(assinatura, sizeof(assinatura));
+    entrada.read(reinterpret_cast<char*>(&registros), sizeof(registros));
+    entrada.read(reinterpret_cast<char*>(&quantidade), sizeof(quantidade));
+    if (!entrada || !equal(assinatura, assinatura + sizeof(assinatura), ASSINATURA_TRACO)) {
+        return false;
+    }
+    
+    streamoff cabecalho = entrada.tellg();
+    entrada.seekg(0, ios::end);
+    uint64_t bytesOperacoes = (uint64_t)(entrada.tellg() - cabecalho);
+    entrada.seekg(cabecalho);
+    if (!entrada || bytesOperacoes % sizeof(Operacao) != 0 || quantidade != bytesOperacoes / sizeof(Operacao)) {
+        return false;
+    }
+    
+    carga.nome = "TRAÇO";
+    carga.registros = registros;
+    carga.operacoes.resize(quantidade);
+    entrada.read(reinterpret_cast<char*>(carga.operacoes.data()), quantidade * sizeof(Operacao));
+    if (!entrada) {
+        return false;
+    }
+    for (const Operacao& operacao : carga.operacoes) {
+        if (operacao.tipo > (uint8_t)TipoOperacao::VARREDURA) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// setw conta bytes; nomes com acento ocupam menos colunas do que bytes em UTF-8.
+// Texto maior que a coluna ainda ganha um espaço para não encostar no seguinte
+string preencherColuna(const string& texto, size_t largura) {
+    size_t colunas = 0;
+    for (unsigned char c : texto) {
+        if ((c & 0xC0) != 0x80) {
+            colunas++;
+        }
+    }
+    return colunas >= largura ? texto + " " : texto + string(largura - colunas, ' ');
+}
+
+// MEDIÇÕES
+// Uma linha de resultado de um teste. Variante separa medições da mesma estratégia
+// (alocador, conjunto de chaves, fase); as métricas ficam na ordem em que foram
+// adicionadas e os tempos são sempre em nanossegundos
+struct Medicao {
+    string teste;
+    string chaves;
+    string estrategia;
+    string variante;
+    size_t tamanho;
+    int repeticao;
+    vector<pair<string, double>> metricas;
+
+    Medicao(const string& nomeTeste, const string& nomeChaves, const string& nomeEstrategia,
+            size_t tamanhoCarga, int numeroRepeticao)
+        : teste(nomeTeste), chaves(nomeChaves), estrategia(nomeEstrategia),
+          tamanho(tamanhoCarga), repeticao(numeroRepeticao) {}
+
+    void adicionar(const string& nome, double valor) {
+        metricas.push_back({nome, valor});
+    }
+};
+
+// MEMÓRIA POR FASE
+// Campo de /proc/self/status em kB (VmRSS, VmHWM); 0 fora do Linux
+size_t lerStatusProcesso(const string& campo) {
+    ifstream status("/proc/self/status");
+    string linha;
+    while (getline(status, linha)) {
+        if (linha.compare(0, campo.size() + 1, campo + ":") == 0) {
+            return stoull(linha.substr(campo.size() + 1));
+        }
+    }
+    return 0;
+}
+
+// Contagem do MedidorMemoria e RSS de uma fase: iniciar() zera o pico (dos contadores e,
+// quando o kernel permite, o VmHWM) e anota as alocações até ali
+class MemoriaFase {
+private:
+    MedidorMemoria::Instantaneo inicio;
+    
+public:
+    MemoriaFase() : inicio(MedidorMemoria::ler()) {}
+    
+    void iniciar() {
+        MedidorMemoria::reiniciarPico();
+        ofstream("/proc/self/clear_refs") << "5";
+        inicio = MedidorMemoria::ler();
+    }
+    
+    void adicionarMetricas(Medicao& medicao, const string& prefixo = "") const {
+        MedidorMemoria::Instantaneo agora = MedidorMemoria::ler();
+        medicao.adicionar(prefixo + "bytes_vivos", agora.bytesVivos);
+        medicao.adicionar(prefixo + "bytes_pico", agora.bytesPico);
+        medicao.adicionar(prefixo + "bytes_reservados", agora.bytesReservados);
+        medicao.adicionar(prefixo + "alocacoes", agora.alocacoes - inicio.alocacoes);
+        medicao.adicionar(prefixo + "rss_kb", lerStatusProcesso("VmRSS"));
+        medicao.adicionar(prefixo + "rss_pico_kb", lerStatusProcesso("VmHWM"));
+    }
+};
+
+// CONTADORES DE HARDWARE
+// Ciclos, falhas de cache e desvios mal previstos desta thread no espaço do usuário, lidos
+// com perf_event_open. PERF_COUNT_HW_CACHE_MISSES é, nos processadores comuns, a falha no
+// último nível de cache. Cada contador abre sozinho: os que o kernel recusa (máquina
+// virtual sem PMU, perf_event_paranoid alto, fora do Linux) ficam de fora, e sem nenhum
+// o teste segue sem eles; obterMotivo() diz por quê
+class ContadoresHardware {
+public:
+    struct Leitura {
+        string nome;
+        long long valor;
+    };
+    
+private:
+    vector<pair<string, int>> contadores;  // nome da métrica e descritor
+    string motivo;
+    
+public:
+    ContadoresHardware() {
+#if defined(HASH_PERF)
+        const pair<const char*, uint64_t> pedidos[] = {{"ciclos", PERF_COUNT_HW_CPU_CYCLES},
+                                                       {"falhas_llc", PERF_COUNT_HW_CACHE_MISSES},
+                                                       {"falhas_desvio", PERF_COUNT_HW_BRANCH_MISSES}};
+        for (const auto& [nome, evento] : pedidos) {
+            perf_event_attr atributos;
+            memset(&atributos, 0, sizeof(atributos));
+            atributos.size = sizeof(atributos);
+            atributos.type = PERF_TYPE_HARDWARE;
+            atributos.config = evento;
+            atributos.disabled = 1;
+            atributos.exclude_kernel = 1;
+            atributos.exclude_hv = 1;
+            int descritor = (int)syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+            if (descritor < 0) {
+                if (motivo.empty()) {
+                    motivo = string(nome) + ": " + strerror(errno);
+                }
+                continue;
+            }
+            contadores.push_back({nome, descritor});
+        }
+#else
+        motivo = "perf_event_open só existe no Linux";
+#endif
+    }
+    
+    ~ContadoresHardware() {
+#if defined(HASH_PERF)
+        for (const auto& contador : contadores) {
+            close(contador.second);
+        }
+#endif
+    }
+    
+    ContadoresHardware(const ContadoresHardware&) = delete;
+    ContadoresHardware& operator=(const ContadoresHardware&) = delete;
+    
+    bool disponivel() const { return !contadores.empty(); }
+    // O primeiro contador recusado; vazio com todos abertos
+    const string& obterMotivo() const { return motivo; }
+    
+    void iniciar() {
+#if defined(HASH_PERF)
+        for (const auto& contador : contadores) {
+            ioctl(contador.second, PERF_EVENT_IOC_RESET, 0);
+            ioctl(contador.second, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    
+    vector<Leitura> parar() {
+        vector<Leitura> leituras;
+#if defined(HASH_PERF)
+        for (const auto& contador : contadores) {
+            ioctl(contador.second, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (const auto& [nome, descritor] : contadores) {
+            long long valor = 0;
+            if (read(descritor, &valor, sizeof(valor)) == (ssize_t)sizeof(valor)) {
+                leituras.push_back({nome, valor});
+            }
+        }
+#endif
+        return leituras;
+    }
+};
+
+// RELATÓRIO
+// Texto: uma tabela por teste, para leitura no terminal. CSV: formato longo, uma
+// métrica por linha. JSON: um vetor de objetos, um por medição.
+enum class FormatoSaida { TEXTO, CSV, JSON };
+
+class Relatorio {
+private:
+    FormatoSaida formato;
+    ostream& saida;
+    uint64_t semente;
+    size_t registros;
+    string cabecalhoAtual;  // colunas da última tabela impressa no modo texto
+
+    // Contagens e tempos em ns saem como inteiros; o resto com precisão suficiente
+    // para não perder informação no CSV/JSON e com 4 casas no texto
+    string formatarValor(double valor) const {
+        ostringstream texto;
+        if (valor == floor(valor) && fabs(valor) < 1e15) {
+            texto << (long long)valor;
+        } else if (formato == FormatoSaida::TEXTO) {
+            texto << fixed << setprecision(4) << valor;
+        } else {
+            texto << setprecision(12) << valor;
+        }
+        return texto.str();
+    }
+
+    static string campoCsv(const string& campo) {
+        if (campo.find_first_of(",\"") == string::npos) {
+            return campo;
+        }
+        string escapado = "\"";
+        for (char c : campo) {
+            escapado += c;
+            if (c == '"') {
+                escapado += '"';
+            }
+        }
+        return escapado + "\"";
+    }
+
+    static string textoJson(const string& campo) {
+        string escapado = "\"";
+        for (char c : campo) {
+            if (c == '"' || c == '\\') {
+                escapado += '\\';
+            }
+            escapado += c;
+        }
+        return escapado + "\"";
+    }
+
+    void registrarTexto(const Medicao& medicao) {
+        size_t larguraVariante = medicao.variante.empty() ? 0 : 18;
+
+        string cabecalho = medicao.teste + (larguraVariante ? "|variante" : "");
+        for (const auto& [nome, valor] : medicao.metricas) {
+            cabecalho += "|" + nome;
+        }
+
+        if (cabecalho != cabecalhoAtual) {
+            cabecalhoAtual = cabecalho;
+            saida << endl << preencherColuna("Estratégia", 16);
+            if (larguraVariante) {
+                saida << preencherColuna("Variante", larguraVariante);
+            }
+            saida << setw(11) << "n" << setw(5) << "rep";
+            for (const auto& [nome, valor] : medicao.metricas) {
+                saida << setw(max(nome.size() + 2, (size_t)14)) << nome;
+            }
+            saida << endl;
+        }
+
+        saida << preencherColuna(medicao.estrategia, 16);
+        if (larguraVariante) {
+            saida << preencherColuna(medicao.variante, larguraVariante);
+        }
+        saida << setw(11) << medicao.tamanho << setw(5) << medicao.repeticao;
+        for (const auto& [nome, valor] : medicao.metricas) {
+            saida << setw(max(nome.size() + 2, (size_t)14)) << formatarValor(valor);
+        }
+        saida << endl;
+    }
+
+public:
+    Relatorio(FormatoSaida formatoSaida, ostream& fluxo, uint64_t sementeExecucao)
+        : formato(formatoSaida), saida(fluxo), semente(sementeExecucao), registros(0) {}
+
+    bool texto() const { return formato == FormatoSaida::TEXTO; }
+    ostream& fluxo() { return saida; }
+
+    void iniciar() {
+        if (formato == FormatoSaida::CSV) {
+            saida << "teste,chaves,estrategia,variante,tamanho,repeticao,semente,metrica,valor" << endl;
+        } else if (formato == FormatoSaida::JSON) {
+            saida << "[";
+        }
+    }
+
+    void secao(const string& titulo) {
+        if (formato != FormatoSaida::TEXTO) {
+            return;
+        }
+        saida << endl
+              << "=========================================================================" << endl
+              << titulo << endl
+              << "=========================================================================" << endl;
+        cabecalhoAtual.clear();
+    }
+
+    void registrar(const Medicao& medicao) {
+        if (formato == FormatoSaida::TEXTO) {
+            registrarTexto(medicao);
+        } else if (formato == FormatoSaida::CSV) {
+            for (const auto& [nome, valor] : medicao.metricas) {
+                saida << campoCsv(medicao.teste) << "," << campoCsv(medicao.chaves) << ","
+                      << campoCsv(medicao.estrategia) << "," << campoCsv(medicao.variante) << ","
+                      << medicao.tamanho << "," << medicao.repeticao << "," << semente << ","
+                      << nome << "," << formatarValor(valor) << "\n";
+            }
+        } else {
+            saida << (registros == 0 ? "\n" : ",\n")
+                  << "  {\"teste\": " << textoJson(medicao.teste)
+                  << ", \"chaves\": " << textoJson(medicao.chaves)
+                  << ", \"estrategia\": " << textoJson(medicao.estrategia)
+                  << ", \"variante\": " << textoJson(medicao.variante)
+                  << ", \"tamanho\": " << medicao.tamanho
+                  << ", \"repeticao\": " << medicao.repeticao
+                  << ", \"semente\": " << semente
+                  << ", \"metricas\": {";
+            for (size_t i = 0; i < medicao.metricas.size(); i++) {
+                saida << (i == 0 ? "" : ", ") << textoJson(medicao.metricas[i].first) << ": "
+                      << formatarValor(medicao.metricas[i].second);
+            }
+            saida << "}}";
+        }
+        registros++;
+    }
+
+    void finalizar() {
+        if (formato == FormatoSaida::JSON) {
+            saida << "\n]" << endl;
+        }
+        saida.flush();
+    }
+};
+
+// OPÇÕES DA LINHA DE COMANDO
+struct OpcoesExecucao {
+    vector<int> testes;
+    vector<size_t> tamanhos;     // vazio: tamanho padrão de cada teste
+    vector<string> estrategias;  // identificadores; vazio: todas
+    vector<string> chaves;       // "int" e/ou "texto"
+    vector<string> cargas;       // misturas do Teste 7; vazio: todas
+    bool distribuicaoFixa;       // falso: a distribuição de cada mistura
+    Distribuicao distribuicao;
+    string arquivoTraco;         // Teste 7 reproduz este traço em vez de gerar as misturas
+    string prefixoTraco;         // grava cada carga gerada em PREFIXO_<mistura>.traco
+    vector<int> threads;         // Testes 8, 9 e 12; vazio: 1, 2, 4... até o número de núcleos
+    size_t fragmentos;
+    string arquivoInstantaneo;   // arquivo temporário do Teste 13
+    uint64_t semente;
+    int repeticoes;
+    FormatoSaida formato;
+    string arquivoSaida;
+    bool instrumentar;           // Teste 3 com InstrumentacaoContada onde a estratégia aceita
+    bool contadoresHardware;     // Teste 3 lê ciclos e falhas de cache e de desvio por fase
+    bool pausar;
+    bool ajuda;
+
+    OpcoesExecucao()
+        : testes({1, 2, 3, 4, 5, 7}), chaves({"int", "texto"}), distribuicaoFixa(false),
+          distribuicao(Distribuicao::ZIPF), fragmentos(64), arquivoInstantaneo("instantaneo.tmp"), semente(42), repeticoes(1),
+          formato(FormatoSaida::TEXTO), instrumentar(false), contadoresHardware(false), pausar(false), ajuda(false) {}
+
+    bool estrategiaSelecionada(const string& identificador) const {
+        return estrategias.empty() || find(estrategias.begin(), estrategias.end(), identificador) != estrategias.end();
+    }
+
+    bool chaveSelecionada(const string& tipo) const {
+        return find(chaves.begin(), chaves.end(), tipo) != chaves.end();
+    }
+
+    bool cargaSelecionada(const string& mistura) const {
+        return cargas.empty() || find(cargas.begin(), cargas.end(), mistura) != cargas.end();
+    }
+
+    vector<size_t> tamanhosOu(size_t padrao) const {
+        return tamanhos.empty() ? vector<size_t>{padrao} : tamanhos;
+    }
+
+    vector<int> threadsOuPadrao() const {
+        if (!threads.empty()) {
+            return threads;
+        }
+        int nucleos = max(1, (int)thread::hardware_concurrency());
+        vector<int> padrao;
+        for (int t = 1; t < nucleos; t *= 2) {
+            padrao.push_back(t);
+        }
+        padrao.push_back(nucleos);
+        return padrao;
+    }
+};
+
+const vector<string> IDENTIFICADORES_ESTRATEGIAS = {
+    "estatica", "duplicacao", "incremental", "linear", "adaptativa", "robinhood", "cuckoo", "extensivel", "simd"
+};
+
+// As chaves são int e o Teste 3 usa 1,5 n chaves com valores até 4,5 n
+const size_t TAMANHO_MAXIMO = 400000000;
+
+void imprimirUso(ostream& saida) {
+    saida << "Uso: Testes_hash_table [opções]" << endl
+          << "  --testes 1,2,3         testes a executar (1-16; padrão 1,2,3,4,5,7)" << endl
+          << "  --tamanhos 1000,1e6    tamanhos de carga (padrão: o de cada teste)" << endl
+          << "  --estrategias a,b      estatica, duplicacao, incremental, linear, adaptativa, robinhood," << endl
+          << "                         cuckoo, extensivel, simd" << endl
+          << "  --chaves int,texto     tipos de chave dos Testes 1 a 3 (padrão ambos)" << endl
+          << "  --semente N            semente dos geradores aleatórios (padrão 42)" << endl
+          << "  --repeticoes N         repetições de cada medição (padrão 1)" << endl
+          << "  --formato texto|csv|json" << endl
+          << "  --saida ARQUIVO        grava o resultado em ARQUIVO em vez da saída padrão" << endl
+          << "  --latencia             inclui o Teste 6 (latência por operação)" << endl
+          << "  --instrumentar         Teste 3 conta hashes, baldes, comparações, alocações e movidos" << endl
+          << "                         por operação, em todas as estratégias" << endl
+          << "  --contadores-hw        Testes 3 e 16 leem ciclos, falhas de LLC e de desvio de cada fase" << endl
+          << "  --cargas A,B,R         misturas do Teste 7: A a F (YCSB) e R (remoções); padrão todas" << endl
+          << "  --distribuicao D       uniforme, zipf, hotspot ou recentes (padrão: a de cada mistura)" << endl
+          << "  --gravar-traco PREFIXO grava as cargas do Teste 7 em PREFIXO_<mistura>.traco" << endl
+          << "  --traco ARQUIVO        Teste 7 reproduz o traço gravado em ARQUIVO" << endl
+          << "  --threads 1,2,4        threads dos Testes 8, 9 e 12 (padrão 1, 2, 4... até o número de núcleos)" << endl
+          << "  --fragmentos N         fragmentos da tabela concorrente do Teste 8 (padrão 64)" << endl
+          << "  --instantaneo ARQUIVO  arquivo temporário do Teste 13 (padrão instantaneo.tmp)" << endl
+          << "  --pausar               espera ENTER antes de cada teste" << endl
+          << "  -h, --ajuda, --help    mostra esta ajuda" << endl;
+}
+
+vector<string> separarLista(const string& lista) {
+    vector<string> itens;
+    string item;
+    istringstream entrada(lista);
+    while (getline(entrada, item, ',')) {
+        if (!item.empty()) {
+            itens.push_back(item);
+        }
+    }
+    return itens;
+}
+
+// Devolve falso e preenche erro quando algum argumento é inválido
+// Opções que recebem valor: qualquer outra é recusada antes de consumir o argumento seguinte
+const char* const OPCOES_COM_VALOR[] = {"--testes", "--tamanhos", "--estrategias", "--chaves", "--cargas",
+                                        "--distribuicao", "--traco", "--gravar-traco", "--instantaneo",
+                                        "--threads", "--fragmentos", "--semente", "--repeticoes", "--formato",
+                                        "--saida"};
+
+bool lerOpcoes(int argc, char* argv[], OpcoesExecucao& opcoes, string& erro) {
+    for (int i = 1; i < argc; i++) {
+        string argumento = argv[i];
+
+        if (argumento == "--ajuda" || argumento == "--help" || argumento == "-h") {
+            opcoes.ajuda = true;
+            continue;
+        }
+        if (argumento == "--pausar") {
+            opcoes.pausar = true;
+            continue;
+        }
+        if (argumento == "--instrumentar") {
+            opcoes.instrumentar = true;
+            continue;
+        }
+        if (argumento == "--contadores-hw") {
+            opcoes.contadoresHardware = true;
+            continue;
+        }
+        if (argumento == "--latencia") {
+            if (find(opcoes.testes.begin(), opcoes.testes.end(), 6) == opcoes.testes.end()) {
+                opcoes.testes.push_back(6);
+            }
+            continue;
+        }
+
+        if (find(begin(OPCOES_COM_VALOR), end(OPCOES_COM_VALOR), argumento) == end(OPCOES_COM_VALOR)) {
+            erro = "opção desconhecida: " + argumento;
+            return false;
+        }
+        if (i + 1 >= argc) {
+            erro = "faltou o valor de " + argumento;
+            return false;
+        }
+        string valor = argv[++i];
+
+        try {
+            if (argumento == "--testes") {
+                opcoes.testes.clear();
+                for (const string& item : separarLista(valor)) {
+                    int teste = stoi(item);
+                    if (teste < 1 || teste > 16) {
+                        erro = "teste inexistente: " + item;
+                        return false;
+                    }
+                    opcoes.testes.push_back(teste);
+                }
+            } else if (argumento == "--tamanhos") {
+                opcoes.tamanhos.clear();
+                for (const string& item : separarLista(valor)) {
+                    // stod aceita tanto 1000000 quanto 1e6
+                    double tamanho = stod(item);
+                    if (tamanho < 1 || tamanho > TAMANHO_MAXIMO) {
+                        erro = "tamanho fora do intervalo [1, " + to_string(TAMANHO_MAXIMO) + "]: " + item;
+                        return false;
+                    }
+                    opcoes.tamanhos.push_back((size_t)tamanho);
+                }
+            } else if (argumento == "--estrategias") {
+                opcoes.estrategias = separarLista(valor);
+                for (const string& estrategia : opcoes.estrategias) {
+                    if (find(IDENTIFICADORES_ESTRATEGIAS.begin(), IDENTIFICADORES_ESTRATEGIAS.end(), estrategia) ==
+                        IDENTIFICADORES_ESTRATEGIAS.end()) {
+                        erro = "estratégia desconhecida: " + estrategia;
+                        return false;
+                    }
+                }
+            } else if (argumento == "--chaves") {
+                opcoes.chaves = separarLista(valor);
+                for (const string& tipo : opcoes.chaves) {
+                    if (tipo != "int" && tipo != "texto") {
+                        erro = "tipo de chave desconhecido: " + tipo;
+                        return false;
+                    }
+                }
+            } else if (argumento == "--cargas") {
+                opcoes.cargas = separarLista(valor);
+                for (string& mistura : opcoes.cargas) {
+                    transform(mistura.begin(), mistura.end(), mistura.begin(), ::toupper);
+                    if (find_if(MISTURAS_YCSB.begin(), MISTURAS_YCSB.end(),
+                                [&](const MisturaOperacoes& m) { return m.nome == mistura; }) == MISTURAS_YCSB.end()) {
+                        erro = "carga desconhecida: " + mistura;
+                        return false;
+                    }
+                }
+            } else if (argumento == "--distribuicao") {
+                if (!lerDistribuicao(valor, opcoes.distribuicao)) {
+                    erro = "distribuição desconhecida: " + valor;
+                    return false;
+                }
+                opcoes.distribuicaoFixa = true;
+            } else if (argumento == "--traco") {
+                opcoes.arquivoTraco = valor;
+            } else if (argumento == "--gravar-traco") {
+                opcoes.prefixoTraco = valor;
+            } else if (argumento == "--instantaneo") {
+                opcoes.arquivoInstantaneo = valor;
+            } else if (argumento == "--threads") {
+                opcoes.threads.clear();
+                for (const string& item : separarLista(valor)) {
+                    int quantidade = stoi(item);
+                    if (quantidade < 1 || quantidade > 1024) {
+                        erro = "número de threads fora do intervalo [1, 1024]: " + item;
+                        return false;
+                    }
+                    opcoes.threads.push_back(quantidade);
+                }
+            } else if (argumento == "--fragmentos") {
+                int quantidade = stoi(valor);
+                if (quantidade < 1 || quantidade > 65536) {
+                    erro = "número de fragmentos fora do intervalo [1, 65536]: " + valor;
+                    return false;
+                }
+                opcoes.fragmentos = quantidade;
+            } else if (argumento == "--semente") {
+                opcoes.semente = stoull(valor);
+            } else if (argumento == "--repeticoes") {
+                opcoes.repeticoes = stoi(valor);
+                if (opcoes.repeticoes < 1) {
+                    erro = "--repeticoes deve ser pelo menos 1";
+                    return false;
+                }
+            } else if (argumento == "--formato") {
+                if (valor == "texto") opcoes.formato = FormatoSaida::TEXTO;
+                else if (valor == "csv") opcoes.formato = FormatoSaida::CSV;
+                else if (valor == "json") opcoes.formato = FormatoSaida::JSON;
+                else {
+                    erro = "formato desconhecido: " + valor;
+                    return false;
+                }
+            } else if (argumento == "--saida") {
+                opcoes.arquivoSaida = valor;
+            } else {
+                erro = "opção desconhecida: " + argumento;
+                return false;
+            }
+        } catch (const exception&) {
+            erro = "valor inválido para " + argumento + ": " + valor;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ESTRATÉGIAS
+// Entrega ao visitante o nome e uma fábrica de cada estratégia selecionada, já com os
+// parâmetros usados em todos os testes. O teste recebe o tipo concreto da tabela por
+// template, então não há despacho por nome nem conversão de ponteiros. Instrumentacao vai
+// para todas as estratégias
+template <typename Chave, typename Instrumentacao = SemInstrumentacao, typename Visitante>
+void paraCadaEstrategia(const OpcoesExecucao& opcoes, Visitante&& visitar) {
+    using Contado = AlocadorContado<Elemento<Chave, int>>;
+    using Duplicacao = TabelaDuplicacao<Chave, int, HashChave<Chave>, equal_to<>, HashBase, Contado, Instrumentacao>;
+    using Adaptativa = TabelaAdaptativa<Chave, int, HashChave<Chave>, equal_to<>, HashBase, Contado,
+                                        ControladorCusto<HashBase>, Instrumentacao>;
+    using RobinHood = TabelaRobinHood<Chave, int, HashChave<Chave>, equal_to<>, HashBase, Contado, Instrumentacao>;
+    using Estatica = TabelaEstatica<Chave, int, HashChave<Chave>, equal_to<>, HashBase, Contado, Instrumentacao>;
+    using Incremental =
+        TabelaIncremental<Chave, int, HashChave<Chave>, equal_to<>, HashBase, Contado, Instrumentacao>;
+    using Linear = TabelaLinear<Chave, int, HashChave<Chave>, equal_to<>, Contado, Instrumentacao>;
+    using Cuckoo = TabelaCuckoo<Chave, int, HashChave<Chave>, equal_to<>, HashBase, Contado, Instrumentacao>;
+    using Extensivel = TabelaExtensivel<Chave, int, HashChave<Chave>, equal_to<>, Contado, Instrumentacao>;
+    using GruposSimd = TabelaGruposSimd<Chave, int, HashChave<Chave>, equal_to<>, Contado, Instrumentacao>;
+    
+    if (opcoes.estrategiaSelecionada("estatica")) {
+        visitar("ESTÁTICA", [] { return make_unique<Estatica>(10007); });
+    }
+    if (opcoes.estrategiaSelecionada("duplicacao")) {
+        visitar("DUPLICAÇÃO", [] { return make_unique<Duplicacao>(8, 0.7, 0.2); });
+    }
+    if (opcoes.estrategiaSelecionada("incremental")) {
+        visitar("INCREMENTAL", [] { return make_unique<Incremental>(8, 0.7, 0.2, 1000); });
+    }
+    if (opcoes.estrategiaSelecionada("linear")) {
+        visitar("LINEAR", [] { return make_unique<Linear>(8, 0.7, 0.2); });
+    }
+    if (opcoes.estrategiaSelecionada("adaptativa")) {
+        visitar("ADAPTATIVA", [] { return make_unique<Adaptativa>(8, 0.7, 0.2); });
+    }
+    if (opcoes.estrategiaSelecionada("robinhood")) {
+        visitar("ROBIN HOOD", [] { return make_unique<RobinHood>(8, 0.9, 0.2); });
+    }
+    if (opcoes.estrategiaSelecionada("cuckoo")) {
+        visitar("CUCKOO", [] { return make_unique<Cuckoo>(8, 0.95, 0.2); });
+    }
+    if (opcoes.estrategiaSelecionada("extensivel")) {
+        visitar("EXTENSÍVEL", [] { return make_unique<Extensivel>(8, 1.0, 0.2); });
+    }
+    if (opcoes.estrategiaSelecionada("simd")) {
+        visitar("GRUPOS SIMD", [] { return make_unique<GruposSimd>(32, 0.875, 0.2); });
+    }
+}
+
+// Métricas que só existem em algumas estratégias
+template <typename Tabela>
+void adicionarDetalhes(Medicao&, const Tabela&) {}
+
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaDuplicacao<Parametros...>& tabela) {
+    medicao.adicionar("movidos_por_insercao", tabela.obterMovidosPorInsercao());
+}
+
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaIncremental<Parametros...>& tabela) {
+    medicao.adicionar("migracao_max_ns", tabela.obterCustoMaximoMigracaoNs());
+}
+
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaLinear<Parametros...>& tabela) {
+    medicao.adicionar("divisoes", tabela.obterDivisoes());
+}
+
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaRobinHood<Parametros...>& tabela) {
+    medicao.adicionar("deslocamento_maximo", tabela.obterDeslocamentoMaximo());
+}
+
+// Caminhos de deslocamento da inserção e quantas vezes não houve caminho
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaCuckoo<Parametros...>& tabela) {
+    medicao.adicionar("caminho_maximo", tabela.obterCaminhoMaximo());
+    medicao.adicionar("caminho_medio", tabela.obterCaminhoMedio());
+    medicao.adicionar("insercoes_deslocadas", tabela.obterInsercoesDeslocadas());
+    medicao.adicionar("falhas_insercao", tabela.obterFalhasInsercao());
+    medicao.adicionar("rehash_por_falha", tabela.obterRehashPorFalha());
+}
+
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaExtensivel<Parametros...>& tabela) {
+    medicao.adicionar("divisoes", tabela.obterDivisoes());
+    medicao.adicionar("profundidade_global", tabela.obterProfundidadeGlobal());
+    medicao.adicionar("bytes_divisao_max", tabela.obterBytesDivisaoMaximo());
+}
+
+template <typename... Parametros>
+void adicionarDetalhes(Medicao& medicao, const TabelaGruposSimd<Parametros...>& tabela) {
+    // Bytes de controle comparados por instrução: 1 (escalar), 16 (SSE2) ou 32 (AVX2)
+    NivelSimd nivel = tabela.obterNivelSimd();
+    medicao.adicionar("sondagem_bytes", nivel == NivelSimd::AVX2 ? 32 : nivel == NivelSimd::SSE2 ? 16 : 1);
+}
+
+// Contagens da instrumentação por tipo de operação; falso nas estratégias sem o parâmetro
+// ou com SemInstrumentacao
+inline bool copiarContagens(const SemInstrumentacao&, ContagemOperacao*) { return false; }
+
+inline bool copiarContagens(const InstrumentacaoContada& instrumentacao, ContagemOperacao* contagens) {
+    for (size_t tipo = 0; tipo < TIPOS_OPERACAO; tipo++) {
+        contagens[tipo] = instrumentacao.obter((OperacaoTabela)tipo);
+    }
+    return true;
+}
+
+template <typename Tabela>
+bool lerInstrumentacao(const Tabela&, ContagemOperacao*) { return false; }
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaEstatica<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaDuplicacao<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaIncremental<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaLinear<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaAdaptativa<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaRobinHood<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaCuckoo<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaExtensivel<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+template <typename... Parametros>
+bool lerInstrumentacao(const TabelaGruposSimd<Parametros...>& tabela, ContagemOperacao* contagens) {
+    return copiarContagens(tabela.obterInstrumentacao(), contagens);
+}
+
+// Bytes escritos pelos eventos de crescimento: no total e no maior evento. Nas tabelas
+// que crescem aos poucos (incremental, linear, extensível) um evento soma vários passos
+template <typename Tabela>
+void adicionarBytesMovidos(Medicao& medicao, const Tabela& tabela) {
+    size_t total = 0;
+    size_t maior = 0;
+    for (const EventoRedimensionamento& evento : tabela.obterEventosRedimensionamento()) {
+        if (evento.capacidadeNova > evento.capacidadeAnterior) {
+            total += evento.bytesMovidos;
+            maior = max(maior, evento.bytesMovidos);
+        }
+    }
+    medicao.adicionar("bytes_movidos", total);
+    medicao.adicionar("bytes_evento_max", maior);
+}
+
+// TESTE 1: INSERÇÕES SEQUENCIAIS
+template <typename Chave>
+void executarTeste1(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 1: " + to_string(total) + " INSERÇÕES SEQUENCIAIS (CHAVES " +
+                    FabricaChave<Chave>::nome() + ")");
+
+    vector<int> dados = gerarNumerosSequenciais(total);
+    vector<Chave> chaves = gerarChaves<Chave>(dados);
+
+    paraCadaEstrategia<Chave>(opcoes, [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            MemoriaFase memoria;
+            memoria.iniciar();
+            auto tabela = criarTabela();
+
+            long long inicio = agoraNs();
+            for (size_t i = 0; i < total; i++) {
+                tabela->inserir(chaves[i], dados[i] * 2);
+            }
+            long long duracao = agoraNs() - inicio;
+
+            Medicao medicao("insercao", FabricaChave<Chave>::nome(), nome, total, repeticao);
+            medicao.adicionar("tempo_ns", duracao);
+            medicao.adicionar("ns_por_operacao", (double)duracao / total);
+            medicao.adicionar("colisoes", tabela->obterColisoes());
+            medicao.adicionar("redimensionamentos", tabela->obterRedimensionamentos());
+            medicao.adicionar("fator_carga", tabela->obterFatorCarga());
+            memoria.adicionarMetricas(medicao);
+            adicionarBytesMovidos(medicao, *tabela);
+            adicionarDetalhes(medicao, *tabela);
+            relatorio.registrar(medicao);
+        }
+    });
+}
+
+// TESTE 2: OPERAÇÕES MISTAS (50% INSERÇÃO, 50% BUSCA)
+// Universo de 0,4 n + 1 chaves e pré-carga de n / 50, as proporções do teste original
+// (500.000 operações, 200.001 chaves, 10.000 pré-inseridas)
+template <typename Chave>
+void executarTeste2(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 2: " + to_string(total) + " OPERAÇÕES MISTAS (50% INSERÇÃO, 50% BUSCA) (CHAVES " +
+                    FabricaChave<Chave>::nome() + ")");
+
+    size_t tamanhoUniverso = total * 2 / 5 + 1;
+    size_t preCarga = min(total / 50, tamanhoUniverso);
+    vector<Chave> universo = gerarChaves<Chave>(gerarNumerosSequenciais(tamanhoUniverso));
+
+    paraCadaEstrategia<Chave>(opcoes, [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            MemoriaFase memoria;
+            memoria.iniciar();
+            auto tabela = criarTabela();
+
+            // Mesma sequência de operações para todas as estratégias e repetições
+            mt19937_64 gerador(opcoes.semente);
+            uniform_int_distribution<size_t> distChaves(0, tamanhoUniverso - 1);
+            uniform_real_distribution<> distOperacoes(0.0, 1.0);
+
+            size_t insercoes = 0;
+            size_t buscas = 0;
+            size_t buscasComSucesso = 0;
+
+            long long inicio = agoraNs();
+
+            for (size_t i = 0; i < preCarga; i++) {
+                tabela->inserir(universo[i], (int)i * 2);
+            }
+
+            for (size_t i = 0; i < total; i++) {
+                size_t numero = distChaves(gerador);
+
+                if (distOperacoes(gerador) < 0.5) {
+                    tabela->inserir(universo[numero], (int)numero * 3);
+                    insercoes++;
+                } else {
+                    int valor;
+                    if (tabela->buscar(FabricaChave<Chave>::consulta(universo[numero]), valor)) {
+                        buscasComSucesso++;
+                    }
+                    buscas++;
+                }
+            }
+
+            long long duracao = agoraNs() - inicio;
+
+            Medicao medicao("mista", FabricaChave<Chave>::nome(), nome, total, repeticao);
+            medicao.adicionar("tempo_ns", duracao);
+            medicao.adicionar("ns_por_operacao", (double)duracao / total);
+            medicao.adicionar("insercoes", insercoes);
+            medicao.adicionar("buscas", buscas);
+            medicao.adicionar("buscas_sucesso", buscasComSucesso);
+            medicao.adicionar("redimensionamentos", tabela->obterRedimensionamentos());
+            memoria.adicionarMetricas(medicao);
+            relatorio.registrar(medicao);
+        }
+    });
+}
+
+// TESTE 3: CARGA VARIÁVEL
+// Fase 1 insere n, fase 2 faz n buscas aleatórias, fase 3 remove n / 2 e insere n / 2
+// chaves novas (o teste original usa n = 100.000). Com --instrumentar, todas as estratégias
+// contam o trabalho de cada operação em cada fase; com
+// --contadores-hw, cada fase é cercada pelos contadores de hardware
+template <typename Chave>
+void executarTeste3(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 3: CARGA VARIÁVEL COM FASES DIFERENTES, n = " + to_string(total) + " (CHAVES " +
+                    FabricaChave<Chave>::nome() + ")");
+
+    vector<Chave> universo = gerarChaves<Chave>(gerarNumerosSequenciais(total + total / 2));
+
+    // A memória, as cadeias e os contadores de cada fase vão em tabelas próprias, depois
+    // dos tempos
+    vector<Medicao> memorias;
+    vector<Medicao> cadeias;
+    vector<Medicao> instrumentacoes;
+    vector<Medicao> contadores;
+
+    unique_ptr<ContadoresHardware> hardware;
+    if (opcoes.contadoresHardware) {
+        hardware = make_unique<ContadoresHardware>();
+        if (!hardware->disponivel()) {
+            cerr << "Aviso: contadores de hardware indisponíveis (" << hardware->obterMotivo() << ")" << endl;
+            hardware.reset();
+        }
+    }
+
+    auto medir = [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            MemoriaFase memoria;
+            memoria.iniciar();
+            auto tabela = criarTabela();
+            mt19937_64 gerador(opcoes.semente);
+            uniform_int_distribution<size_t> dist(0, total - 1);
+
+            auto registrarMemoria = [&](int fase) {
+                Medicao medicao("fases_memoria", FabricaChave<Chave>::nome(), nome, total, repeticao);
+                medicao.variante = "FASE " + to_string(fase);
+                memoria.adicionarMetricas(medicao);
+                memorias.push_back(medicao);
+                memoria.iniciar();
+            };
+
+            // Retrato das estatísticas vivas, fora do tempo das fases
+            auto registrarCadeias = [&](int fase) {
+                long long inicioRetrato = agoraNs();
+                EstatisticasTabela e = tabela->obterEstatisticas();
+                long long duracaoRetrato = agoraNs() - inicioRetrato;
+
+                Medicao medicao("fases_cadeias", FabricaChave<Chave>::nome(), nome, total, repeticao);
+                medicao.variante = "FASE " + to_string(fase);
+                medicao.adicionar("elementos", e.elementos);
+                medicao.adicionar("baldes_ocupados", e.baldesOcupados);
+                medicao.adicionar("colisoes", tabela->obterColisoes());
+                medicao.adicionar("cadeia_maxima", e.cadeiaMaxima);
+                medicao.adicionar("sondas_acerto", e.sondasAcerto);
+                medicao.adicionar("sondas_falha", e.sondasFalha);
+                medicao.adicionar("retrato_ns", duracaoRetrato);
+                cadeias.push_back(medicao);
+            };
+
+            // Instrumentação e hardware cercam só o laço cronometrado de cada fase
+            ContagemOperacao contagensAntes[TIPOS_OPERACAO];
+            auto iniciarContadores = [&] {
+                lerInstrumentacao(*tabela, contagensAntes);
+                if (hardware) {
+                    hardware->iniciar();
+                }
+            };
+            auto registrarContadores = [&](int fase, size_t operacoes) {
+                vector<ContadoresHardware::Leitura> leituras;
+                if (hardware) {
+                    leituras = hardware->parar();
+                }
+                if (!leituras.empty()) {
+                    Medicao medicao("fases_hardware", FabricaChave<Chave>::nome(), nome, total, repeticao);
+                    medicao.variante = "FASE " + to_string(fase);
+                    for (const ContadoresHardware::Leitura& leitura : leituras) {
+                        medicao.adicionar(leitura.nome, leitura.valor);
+                        medicao.adicionar(leitura.nome + "_por_operacao", (double)leitura.valor / operacoes);
+                    }
+                    contadores.push_back(medicao);
+                }
+                
+                ContagemOperacao contagens[TIPOS_OPERACAO];
+                if (!lerInstrumentacao(*tabela, contagens)) {
+                    return;
+                }
+                for (size_t tipo = 0; tipo < TIPOS_OPERACAO; tipo++) {
+                    ContagemOperacao c = contagens[tipo] - contagensAntes[tipo];
+                    if (c.operacoes == 0) {
+                        continue;
+                    }
+                    Medicao medicao("fases_instrumentacao", FabricaChave<Chave>::nome(), nome, total, repeticao);
+                    medicao.variante = "FASE " + to_string(fase) + " " + nomeOperacao((OperacaoTabela)tipo);
+                    medicao.adicionar("operacoes", c.operacoes);
+                    medicao.adicionar("hashes_por_operacao", (double)c.hashes / c.operacoes);
+                    medicao.adicionar("baldes_por_operacao", (double)c.baldes / c.operacoes);
+                    medicao.adicionar("comparacoes_por_operacao", (double)c.comparacoes / c.operacoes);
+                    medicao.adicionar("alocacoes_por_operacao", (double)c.alocacoes / c.operacoes);
+                    medicao.adicionar("movidos_por_operacao", (double)c.movidos / c.operacoes);
+                    instrumentacoes.push_back(medicao);
+                }
+            };
+
+            // FASE 1: Inserção
+            iniciarContadores();
+            long long inicio = agoraNs();
+            for (size_t i = 0; i < total; i++) {
+                tabela->inserir(universo[i], (int)i * 2);
+            }
+            long long fimFase1 = agoraNs();
+            registrarContadores(1, total);
+            registrarMemoria(1);
+            registrarCadeias(1);
+
+            // FASE 2: Buscas
+            iniciarContadores();
+            long long inicioFase2 = agoraNs();
+            size_t acertos = 0;
+            for (size_t i = 0; i < total; i++) {
+                int valor;
+                if (tabela->buscar(FabricaChave<Chave>::consulta(universo[dist(gerador)]), valor)) {
+                    acertos++;
+                }
+            }
+            long long fimFase2 = agoraNs();
+            registrarContadores(2, total);
+            registrarMemoria(2);
+            registrarCadeias(2);
+
+            // FASE 3: Remoções e novas inserções
+            iniciarContadores();
+            long long inicioFase3 = agoraNs();
+            for (size_t i = 0; i < total / 2; i++) {
+                tabela->remover(FabricaChave<Chave>::consulta(universo[i]));
+            }
+            for (size_t i = total; i < total + total / 2; i++) {
+                tabela->inserir(universo[i], (int)i * 3);
+            }
+            long long fimFase3 = agoraNs();
+            registrarContadores(3, total / 2 + total / 2);
+            registrarMemoria(3);
+            registrarCadeias(3);
+
+            Medicao medicao("fases", FabricaChave<Chave>::nome(), nome, total, repeticao);
+            medicao.adicionar("fase1_ns", fimFase1 - inicio);
+            medicao.adicionar("fase2_ns", fimFase2 - inicioFase2);
+            medicao.adicionar("fase3_ns", fimFase3 - inicioFase3);
+            medicao.adicionar("total_ns", (fimFase1 - inicio) + (fimFase2 - inicioFase2) + (fimFase3 - inicioFase3));
+            medicao.adicionar("acertos", acertos);
+            medicao.adicionar("colisoes", tabela->obterColisoes());
+            medicao.adicionar("redimensionamentos", tabela->obterRedimensionamentos());
+            medicao.adicionar("fator_carga", tabela->obterFatorCarga());
+            relatorio.registrar(medicao);
+        }
+    };
+    if (opcoes.instrumentar) {
+        paraCadaEstrategia<Chave, InstrumentacaoContada>(opcoes, medir);
+    } else {
+        paraCadaEstrategia<Chave>(opcoes, medir);
+    }
+
+    for (const vector<Medicao>* tabelaFases : {&memorias, &cadeias, &instrumentacoes, &contadores}) {
+        for (const Medicao& medicao : *tabelaFases) {
+            relatorio.registrar(medicao);
+        }
+    }
+}
+
+// TESTE 4: POLÍTICAS DE HASH
+// Mede o custo de cada política isoladamente (ns por hash) e a distribuição do
+// comprimento das cadeias que ela produz para o mesmo conjunto de chaves
+template <typename PoliticaHash>
+void medirPoliticaHash(Relatorio& relatorio, const string& nome, const string& conjunto,
+                       const vector<int>& chaves, size_t capacidadePedida, int repeticao) {
+    PoliticaHash politica;
+    size_t capacidade = PoliticaHash::capacidadeValida(capacidadePedida);
+    politica.ajustar(capacidade);
+
+    const int VOLTAS = 20;
+    size_t soma = 0;
+
+    long long inicio = agoraNs();
+    for (int r = 0; r < VOLTAS; r++) {
+        for (int chave : chaves) {
+            soma += politica.indice(chave);
+        }
+    }
+    long long duracao = agoraNs() - inicio;
+
+    // Impede que o compilador descarte o laço medido
+    volatile size_t sumidouro = soma;
+    (void)sumidouro;
+
+    vector<size_t> comprimentos(capacidade, 0);
+    for (int chave : chaves) {
+        comprimentos[politica.indice(chave)]++;
+    }
+
+    // Distribuição: baldes com 0, 1, 2, 3, 4 e 5+ elementos
+    vector<size_t> distribuicao(6, 0);
+    size_t maiorCadeia = 0;
+    for (size_t comprimento : comprimentos) {
+        distribuicao[min(comprimento, (size_t)5)]++;
+        maiorCadeia = max(maiorCadeia, comprimento);
+    }
+
+    Medicao medicao("politicas", "INTEIRAS", nome, chaves.size(), repeticao);
+    medicao.variante = conjunto;
+    medicao.adicionar("baldes", capacidade);
+    medicao.adicionar("ns_por_hash", (double)duracao / ((double)VOLTAS * chaves.size()));
+    medicao.adicionar("vazios", distribuicao[0]);
+    medicao.adicionar("baldes_1", distribuicao[1]);
+    medicao.adicionar("baldes_2", distribuicao[2]);
+    medicao.adicionar("baldes_3", distribuicao[3]);
+    medicao.adicionar("baldes_4", distribuicao[4]);
+    medicao.adicionar("baldes_5_mais", distribuicao[5]);
+    medicao.adicionar("maior_cadeia", maiorCadeia);
+    relatorio.registrar(medicao);
+}
+
+void executarTeste4(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 4: POLÍTICAS DE HASH (MICRO-BENCHMARK), " + to_string(total) + " CHAVES");
+
+    // Potência de 2 que comporta as chaves (2^20 para 1 milhão)
+    size_t capacidade = 1;
+    while (capacidade < total) {
+        capacidade *= 2;
+    }
+
+    vector<pair<string, vector<int>>> conjuntos = {
+        {"SEQUENCIAIS", gerarNumerosSequenciais(total)},
+        {"ALEATÓRIAS", gerarNumerosAleatorios(total, opcoes.semente, max(1000000, (int)total))}
+    };
+
+    for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+        for (const auto& [nomeConjunto, chaves] : conjuntos) {
+            medirPoliticaHash<HashBase>(relatorio, "BASE (% p % m)", nomeConjunto, chaves, capacidade, repeticao);
+            medirPoliticaHash<HashMultiplicativo>(relatorio, "MULT-DESLOC", nomeConjunto, chaves, capacidade, repeticao);
+            medirPoliticaHash<HashFastrange>(relatorio, "FASTRANGE", nomeConjunto, chaves, capacidade, repeticao);
+            medirPoliticaHash<HashPrimoReciproco>(relatorio, "FASTMOD (PRIMO)", nomeConjunto, chaves, capacidade, repeticao);
+        }
+    }
+}
+
+// TESTE 5: ALOCADOR DOS NÓS (std::allocator x POOL)
+// Mesma carga para cada estratégia encadeada com os dois alocadores: inserções
+// sequenciais, depois a rotatividade da FASE 3 (remove metade, insere outra metade)
+// e por fim a destruição da tabela, onde o pool devolve a memória em bloco
+template <typename Tabela, typename... Argumentos>
+void medirAlocador(Relatorio& relatorio, const string& nome, const string& nomeAlocador, size_t total,
+                   int repeticao, Argumentos... argumentos) {
+    long long inicio = agoraNs();
+
+    Tabela* tabela = new Tabela(argumentos...);
+    for (size_t i = 0; i < total; i++) {
+        tabela->inserir((int)i, (int)i * 2);
+    }
+    long long fimInsercao = agoraNs();
+
+    for (size_t i = 0; i < total / 2; i++) {
+        tabela->remover((int)i);
+    }
+    for (size_t i = total; i < total + total / 2; i++) {
+        tabela->inserir((int)i, (int)i * 3);
+    }
+    long long fimRotatividade = agoraNs();
+
+    delete tabela;
+    long long fimDestruicao = agoraNs();
+
+    Medicao medicao("alocador", "INTEIRAS", nome, total, repeticao);
+    medicao.variante = nomeAlocador;
+    medicao.adicionar("insercao_ns", fimInsercao - inicio);
+    medicao.adicionar("rotatividade_ns", fimRotatividade - fimInsercao);
+    medicao.adicionar("destruicao_ns", fimDestruicao - fimRotatividade);
+    relatorio.registrar(medicao);
+}
+
+using AlocadorPadraoInt = allocator<Elemento<int, int>>;
+using AlocadorPoolInt = AlocadorPool<Elemento<int, int>>;
+
+template <typename Alocador>
+using EstaticaCom = TabelaEstatica<int, int, HashChave<int>, equal_to<>, HashBase, Alocador>;
+template <typename Alocador>
+using DuplicacaoCom = TabelaDuplicacao<int, int, HashChave<int>, equal_to<>, HashBase, Alocador>;
+template <typename Alocador>
+using IncrementalCom = TabelaIncremental<int, int, HashChave<int>, equal_to<>, HashBase, Alocador>;
+template <typename Alocador>
+using LinearCom = TabelaLinear<int, int, HashChave<int>, equal_to<>, Alocador>;
+template <typename Alocador>
+using AdaptativaCom = TabelaAdaptativa<int, int, HashChave<int>, equal_to<>, HashBase, Alocador>;
+
+void executarTeste5(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 5: ALOCADOR DOS NÓS (std::allocator x POOL), n = " + to_string(total));
+
+    for (int r = 1; r <= opcoes.repeticoes; r++) {
+        if (opcoes.estrategiaSelecionada("estatica")) {
+            medirAlocador<EstaticaCom<AlocadorPadraoInt>>(relatorio, "ESTÁTICA", "std::allocator", total, r, 10007);
+            medirAlocador<EstaticaCom<AlocadorPoolInt>>(relatorio, "ESTÁTICA", "pool", total, r, 10007);
+        }
+        if (opcoes.estrategiaSelecionada("duplicacao")) {
+            medirAlocador<DuplicacaoCom<AlocadorPadraoInt>>(relatorio, "DUPLICAÇÃO", "std::allocator", total, r, 8, 0.7, 0.2);
+            medirAlocador<DuplicacaoCom<AlocadorPoolInt>>(relatorio, "DUPLICAÇÃO", "pool", total, r, 8, 0.7, 0.2);
+        }
+        if (opcoes.estrategiaSelecionada("incremental")) {
+            medirAlocador<IncrementalCom<AlocadorPadraoInt>>(relatorio, "INCREMENTAL", "std::allocator", total, r, 8, 0.7, 0.2, 1000);
+            medirAlocador<IncrementalCom<AlocadorPoolInt>>(relatorio, "INCREMENTAL", "pool", total, r, 8, 0.7, 0.2, 1000);
+        }
+        if (opcoes.estrategiaSelecionada("linear")) {
+            medirAlocador<LinearCom<AlocadorPadraoInt>>(relatorio, "LINEAR", "std::allocator", total, r, 8, 0.7, 0.2);
+            medirAlocador<LinearCom<AlocadorPoolInt>>(relatorio, "LINEAR", "pool", total, r, 8, 0.7, 0.2);
+        }
+        if (opcoes.estrategiaSelecionada("adaptativa")) {
+            medirAlocador<AdaptativaCom<AlocadorPadraoInt>>(relatorio, "ADAPTATIVA", "std::allocator", total, r, 8, 0.7, 0.2);
+            medirAlocador<AdaptativaCom<AlocadorPoolInt>>(relatorio, "ADAPTATIVA", "pool", total, r, 8, 0.7, 0.2);
+        }
+    }
+}
+
+// HISTOGRAMA DE LATÊNCIA
+// Baldes log-lineares no estilo HDR: 32 sub-baldes por potência de 2, então cada valor
+// é guardado com erro relativo abaixo de 3% e registrar custa um clz e um incremento
+class HistogramaLatencia {
+private:
+    static const int BITS_SUBBALDE = 5;
+    static const size_t SUBBALDES = 1 << BITS_SUBBALDE;
+    
+    vector<uint64_t> contagens;
+    uint64_t total;
+    uint64_t maximo;
+    
+    static size_t indice(uint64_t valor) {
+        if (valor < SUBBALDES) {
+            return valor;
+        }
+        int expoente = 63 - __builtin_clzll(valor);
+        return (expoente - BITS_SUBBALDE + 1) * SUBBALDES + ((valor >> (expoente - BITS_SUBBALDE)) & (SUBBALDES - 1));
+    }
+    
+    // Maior valor que cai no balde
+    static uint64_t limiteSuperior(size_t balde) {
+        if (balde < SUBBALDES) {
+            return balde;
+        }
+        int deslocamento = balde / SUBBALDES - 1;
+        uint64_t base = SUBBALDES + balde % SUBBALDES;
+        return ((base + 1) << deslocamento) - 1;
+    }
+    
+public:
+    HistogramaLatencia() : contagens((64 - BITS_SUBBALDE + 1) * SUBBALDES, 0), total(0), maximo(0) {}
+    
+    void registrar(uint64_t valor) {
+        contagens[indice(valor)]++;
+        total++;
+        maximo = max(maximo, valor);
+    }
+    
+    // Valor que cobre p% das amostras (limite do balde, nunca acima do máximo visto)
+    uint64_t percentil(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t posicao = max((uint64_t)1, (uint64_t)ceil(p / 100.0 * total));
+        uint64_t acumulado = 0;
+        for (size_t i = 0; i < contagens.size(); i++) {
+            acumulado += contagens[i];
+            if (acumulado >= posicao) {
+                return min(limiteSuperior(i), maximo);
+            }
+        }
+        return maximo;
+    }
+    
+    uint64_t obterTotal() const { return total; }
+    uint64_t obterMaximo() const { return maximo; }
+};
+
+// REGISTRADOR DE LATÊNCIA
+// Cronometra cada operação isoladamente e guarda as mais lentas com o instante em que
+// começaram, para cruzá-las com a linha do tempo dos redimensionamentos da tabela
+class RegistradorLatencia {
+public:
+    struct Pico {
+        long long inicioNs;
+        uint64_t duracaoNs;
+    };
+    
+private:
+    static const size_t PICOS_GUARDADOS = 8;
+    
+    HistogramaLatencia histograma;
+    vector<Pico> picos;
+    uint64_t limiarPico;  // menor duração entre os picos guardados, quando cheio
+    
+    void guardarPico(long long inicio, uint64_t duracao) {
+        if (picos.size() < PICOS_GUARDADOS) {
+            picos.push_back({inicio, duracao});
+        } else {
+            auto menor = min_element(picos.begin(), picos.end(),
+                                     [](const Pico& a, const Pico& b) { return a.duracaoNs < b.duracaoNs; });
+            *menor = {inicio, duracao};
+        }
+        
+        if (picos.size() == PICOS_GUARDADOS) {
+            limiarPico = min_element(picos.begin(), picos.end(),
+                                     [](const Pico& a, const Pico& b) { return a.duracaoNs < b.duracaoNs; })->duracaoNs;
+        }
+    }
+    
+public:
+    RegistradorLatencia() : limiarPico(0) {}
+    
+    template <typename Operacao>
+    void medir(Operacao&& operacao) {
+        long long inicio = agoraNs();
+        operacao();
+        uint64_t duracao = agoraNs() - inicio;
+        
+        histograma.registrar(duracao);
+        if (duracao > limiarPico) {
+            guardarPico(inicio, duracao);
+        }
+    }
+    
+    const HistogramaLatencia& obterHistograma() const { return histograma; }
+    
+    // Do mais lento para o mais rápido
+    vector<Pico> obterPicos() const {
+        vector<Pico> ordenados = picos;
+        sort(ordenados.begin(), ordenados.end(),
+             [](const Pico& a, const Pico& b) { return a.duracaoNs > b.duracaoNs; });
+        return ordenados;
+    }
+};
+
+// TESTE 6: LATÊNCIA POR OPERAÇÃO (opcional, --latencia)
+// As fases do Teste 3 com cada inserir/buscar/remover cronometrado. O tempo total
+// esconde a pausa do rehash completo; aqui ela aparece na cauda (p99.9/máx) e cada
+// pico é atribuído ao redimensionamento que estava em andamento
+template <typename Tabela>
+void medirLatencias(const OpcoesExecucao& opcoes, Relatorio& relatorio, const string& nome, Tabela& tabela,
+                    size_t total, int repeticao) {
+    RegistradorLatencia fases[3];
+    long long inicioTeste = agoraNs();
+    int n = (int)total;
+
+    // FASE 1: Inserção
+    for (int i = 0; i < n; i++) {
+        fases[0].medir([&] { tabela.inserir(i, i * 2); });
+    }
+
+    // FASE 2: Buscas; os acertos são contados para a busca não ser descartada pelo
+    // compilador como código sem efeito
+    mt19937_64 gerador(opcoes.semente);
+    uniform_int_distribution<> dist(0, n - 1);
+    size_t acertos = 0;
+
+    for (int i = 0; i < n; i++) {
+        int chave = dist(gerador);
+        int valor;
+        fases[1].medir([&] { acertos += tabela.buscar(chave, valor); });
+    }
+
+    // FASE 3: Remoções e novas inserções
+    for (int i = 0; i < n / 2; i++) {
+        fases[2].medir([&] { tabela.remover(i); });
+    }
+    for (int i = n; i < n + n / 2; i++) {
+        fases[2].medir([&] { tabela.inserir(i, i * 3); });
+    }
+
+    for (int f = 0; f < 3; f++) {
+        const HistogramaLatencia& h = fases[f].obterHistograma();
+        Medicao medicao("latencia", "INTEIRAS", nome, total, repeticao);
+        medicao.variante = "FASE " + to_string(f + 1);
+        medicao.adicionar("operacoes", h.obterTotal());
+        medicao.adicionar("p50_ns", h.percentil(50));
+        medicao.adicionar("p90_ns", h.percentil(90));
+        medicao.adicionar("p99_ns", h.percentil(99));
+        medicao.adicionar("p99_9_ns", h.percentil(99.9));
+        medicao.adicionar("max_ns", h.obterMaximo());
+        if (f == 1) {
+            medicao.adicionar("acertos", acertos);
+        }
+        relatorio.registrar(medicao);
+    }
+
+    // Linha do tempo; duracao_ns = -1 indica migração ainda em curso no fim do teste
+    const vector<EventoRedimensionamento>& eventos = tabela.obterEventosRedimensionamento();
+    for (size_t i = 0; i < eventos.size(); i++) {
+        const EventoRedimensionamento& e = eventos[i];
+        Medicao medicao("redimensionamentos", "INTEIRAS", nome, total, repeticao);
+        medicao.variante = "#" + to_string(i + 1);
+        medicao.adicionar("inicio_ns", e.inicioNs - inicioTeste);
+        medicao.adicionar("duracao_ns", e.fimNs != 0 ? e.fimNs - e.inicioNs : -1);
+        medicao.adicionar("capacidade_anterior", e.capacidadeAnterior);
+        medicao.adicionar("capacidade_nova", e.capacidadeNova);
+        medicao.adicionar("movidos", e.elementosMovidos);
+        medicao.adicionar("bytes_movidos", e.bytesMovidos);
+        relatorio.registrar(medicao);
+    }
+
+    // As mais lentas das três fases juntas
+    vector<pair<RegistradorLatencia::Pico, int>> picos;
+    for (int f = 0; f < 3; f++) {
+        for (const RegistradorLatencia::Pico& pico : fases[f].obterPicos()) {
+            picos.push_back({pico, f + 1});
+        }
+    }
+    sort(picos.begin(), picos.end(),
+         [](const auto& a, const auto& b) { return a.first.duracaoNs > b.first.duracaoNs; });
+    picos.resize(min(picos.size(), (size_t)8));
+
+    for (size_t p = 0; p < picos.size(); p++) {
+        const auto& [pico, fase] = picos[p];
+        long long fimPico = pico.inicioNs + (long long)pico.duracaoNs;
+
+        // Número do redimensionamento sobreposto ao pico; 0 = nenhum
+        size_t atribuido = 0;
+        for (size_t i = 0; i < eventos.size(); i++) {
+            // Evento ainda aberto (migração incremental em curso) vale até o fim do pico
+            long long fimEvento = eventos[i].fimNs != 0 ? eventos[i].fimNs : fimPico;
+            if (eventos[i].inicioNs <= fimPico && fimEvento >= pico.inicioNs) {
+                atribuido = i + 1;
+            }
+        }
+
+        Medicao medicao("picos", "INTEIRAS", nome, total, repeticao);
+        medicao.variante = "PICO " + to_string(p + 1);
+        medicao.adicionar("duracao_ns", pico.duracaoNs);
+        medicao.adicionar("instante_ns", pico.inicioNs - inicioTeste);
+        medicao.adicionar("fase", fase);
+        medicao.adicionar("redimensionamento", atribuido);
+        relatorio.registrar(medicao);
+    }
+}
+
+void executarTeste6(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 6: LATÊNCIA POR OPERAÇÃO (p50/p90/p99/p99.9/máx), n = " + to_string(total));
+
+    paraCadaEstrategia<int>(opcoes, [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            auto tabela = criarTabela();
+            medirLatencias(opcoes, relatorio, nome, *tabela, total, repeticao);
+        }
+    });
+}
+
+// TESTE 7: CARGAS DE TRABALHO (YCSB A-F E REMOÇÕES)
+// Cada carga insere os registros (carga_ns) e depois executa a sequência de operações
+// gerada ou lida do traço (tempo_ns). As mesmas cargas servem a todas as estratégias
+// Devolve falso e preenche erro quando o traço não pode ser lido ou gravado
+bool prepararCargas(const OpcoesExecucao& opcoes, size_t total, vector<Carga>& cargas, string& erro) {
+    cargas.clear();
+    if (!opcoes.arquivoTraco.empty()) {
+        Carga carga;
+        if (!lerTraco(opcoes.arquivoTraco, carga)) {
+            erro = "traço inválido: " + opcoes.arquivoTraco;
+            return false;
+        }
+        cargas.push_back(move(carga));
+        return true;
+    }
+
+    for (const MisturaOperacoes& mistura : MISTURAS_YCSB) {
+        if (!opcoes.cargaSelecionada(mistura.nome)) continue;
+        Distribuicao distribuicao = opcoes.distribuicaoFixa ? opcoes.distribuicao : mistura.distribuicao;
+        cargas.push_back(gerarCarga(mistura, distribuicao, total, total, opcoes.semente));
+        cargas.back().nome += " " + nomeDistribuicao(distribuicao);
+
+        if (!opcoes.prefixoTraco.empty()) {
+            string arquivo = opcoes.prefixoTraco + "_" + mistura.nome + ".traco";
+            if (!gravarTraco(arquivo, cargas.back())) {
+                erro = "não foi possível gravar " + arquivo;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Chave>
+void executarTeste7(const OpcoesExecucao& opcoes, Relatorio& relatorio, const vector<Carga>& cargas) {
+    for (const Carga& carga : cargas) {
+        relatorio.secao("TESTE 7: CARGA " + carga.nome + ", " + to_string(carga.registros) + " REGISTROS, " +
+                        to_string(carga.operacoes.size()) + " OPERAÇÕES (CHAVES " + FabricaChave<Chave>::nome() + ")");
+
+        size_t tamanhoUniverso = carga.universo();
+        vector<Chave> universo = gerarChaves<Chave>(gerarNumerosSequenciais(tamanhoUniverso));
+
+        paraCadaEstrategia<Chave>(opcoes, [&](const string& nome, auto criarTabela) {
+            for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+                MemoriaFase memoria;
+                memoria.iniciar();
+                auto tabela = criarTabela();
+
+                long long inicio = agoraNs();
+                for (size_t i = 0; i < carga.registros; i++) {
+                    tabela->inserir(universo[i], (int)i);
+                }
+                long long fimCarga = agoraNs();
+
+                size_t leituras = 0;
+                size_t acertos = 0;
+                size_t escritas = 0;
+                size_t remocoes = 0;
+
+                for (const Operacao& operacao : carga.operacoes) {
+                    const Chave& chave = universo[operacao.chave];
+                    int valor;
+
+                    switch ((TipoOperacao)operacao.tipo) {
+                        case TipoOperacao::BUSCAR:
+                            leituras++;
+                            if (tabela->buscar(FabricaChave<Chave>::consulta(chave), valor)) acertos++;
+                            break;
+                        case TipoOperacao::ATUALIZAR:
+                        case TipoOperacao::INSERIR:
+                            escritas++;
+                            tabela->inserir(chave, (int)operacao.chave);
+                            break;
+                        case TipoOperacao::REMOVER:
+                            remocoes++;
+                            tabela->remover(FabricaChave<Chave>::consulta(chave));
+                            break;
+                        case TipoOperacao::LER_MODIFICAR_ESCREVER:
+                            leituras++;
+                            escritas++;
+                            valor = 0;
+                            if (tabela->buscar(FabricaChave<Chave>::consulta(chave), valor)) acertos++;
+                            tabela->inserir(chave, valor + 1);
+                            break;
+                        case TipoOperacao::VARREDURA: {
+                            size_t fim = min((size_t)operacao.chave + operacao.comprimento, tamanhoUniverso);
+                            for (size_t k = operacao.chave; k < fim; k++) {
+                                leituras++;
+                                if (tabela->buscar(FabricaChave<Chave>::consulta(universo[k]), valor)) acertos++;
+                            }
+                            break;
+                        }
+                    }
+                }
+
+                long long fim = agoraNs();
+                size_t operacoes = carga.operacoes.size();
+
+                Medicao medicao("cargas", FabricaChave<Chave>::nome(), nome, carga.registros, repeticao);
+                medicao.variante = carga.nome;
+                medicao.adicionar("carga_ns", fimCarga - inicio);
+                medicao.adicionar("tempo_ns", fim - fimCarga);
+                medicao.adicionar("ns_por_operacao", operacoes ? (double)(fim - fimCarga) / operacoes : 0.0);
+                medicao.adicionar("leituras", leituras);
+                medicao.adicionar("acertos", acertos);
+                medicao.adicionar("escritas", escritas);
+                medicao.adicionar("remocoes", remocoes);
+                medicao.adicionar("elementos", tabela->obterElementos());
+                medicao.adicionar("redimensionamentos", tabela->obterRedimensionamentos());
+                memoria.adicionarMetricas(medicao);
+                relatorio.registrar(medicao);
+            }
+        });
+    }
+}
+
+// TESTE 8: OPERAÇÕES MISTAS CONCORRENTES
+// O Teste 2 dividido entre T threads sobre a tabela fragmentada, para cada T de --threads.
+// A pré-carga fica fora do tempo; cada thread sorteia a sua parte das operações com a
+// semente + número da thread. A linha "1 FRAG." é a mesma tabela atrás de um mutex
+// global, a referência da escalabilidade
+template <typename Chave>
+void executarTeste8(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 8: " + to_string(total) + " OPERAÇÕES MISTAS CONCORRENTES (CHAVES " +
+                    FabricaChave<Chave>::nome() + ")");
+
+    size_t tamanhoUniverso = total * 2 / 5 + 1;
+    size_t preCarga = min(total / 50, tamanhoUniverso);
+    vector<Chave> universo = gerarChaves<Chave>(gerarNumerosSequenciais(tamanhoUniverso));
+
+    auto medir = [&](const string& nome, size_t fragmentos, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            double vazaoUmaThread = 0;
+
+            for (int quantidadeThreads : opcoes.threadsOuPadrao()) {
+                MemoriaFase memoria;
+                memoria.iniciar();
+                auto tabela = criarTabela(fragmentos);
+
+                for (size_t i = 0; i < preCarga; i++) {
+                    tabela->inserir(universo[i], (int)i * 2);
+                }
+
+                struct Contagem {
+                    size_t insercoes = 0;
+                    size_t buscas = 0;
+                    size_t buscasComSucesso = 0;
+                };
+                vector<Contagem> contagens(quantidadeThreads);
+                atomic<int> prontas(0);
+                atomic<bool> largada(false);
+                vector<thread> trabalhadoras;
+
+                for (int t = 0; t < quantidadeThreads; t++) {
+                    trabalhadoras.emplace_back([&, t] {
+                        size_t operacoes = total / quantidadeThreads + ((size_t)t < total % quantidadeThreads ? 1 : 0);
+                        mt19937_64 gerador(opcoes.semente + t);
+                        uniform_int_distribution<size_t> distChaves(0, tamanhoUniverso - 1);
+                        uniform_real_distribution<> distOperacoes(0.0, 1.0);
+                        Contagem contagem;
+
+                        prontas++;
+                        while (!largada.load(memory_order_acquire)) {
+                            this_thread::yield();
+                        }
+
+                        for (size_t i = 0; i < operacoes; i++) {
+                            size_t numero = distChaves(gerador);
+
+                            if (distOperacoes(gerador) < 0.5) {
+                                tabela->inserir(universo[numero], (int)numero * 3);
+                                contagem.insercoes++;
+                            } else {
+                                int valor;
+                                if (tabela->buscar(FabricaChave<Chave>::consulta(universo[numero]), valor)) {
+                                    contagem.buscasComSucesso++;
+                                }
+                                contagem.buscas++;
+                            }
+                        }
+                        contagens[t] = contagem;
+                    });
+                }
+
+                while (prontas.load() < quantidadeThreads) {
+                    this_thread::yield();
+                }
+                long long inicio = agoraNs();
+                largada.store(true, memory_order_release);
+                for (thread& trabalhadora : trabalhadoras) {
+                    trabalhadora.join();
+                }
+                long long duracao = agoraNs() - inicio;
+
+                Contagem soma;
+                for (const Contagem& contagem : contagens) {
+                    soma.insercoes += contagem.insercoes;
+                    soma.buscas += contagem.buscas;
+                    soma.buscasComSucesso += contagem.buscasComSucesso;
+                }
+                double vazao = duracao > 0 ? total * 1e9 / duracao : 0.0;
+                if (quantidadeThreads == 1) {
+                    vazaoUmaThread = vazao;
+                }
+
+                Medicao medicao("concorrente", FabricaChave<Chave>::nome(), nome, total, repeticao);
+                medicao.variante = to_string(fragmentos) + " FRAG. " + to_string(quantidadeThreads) + " THR.";
+                medicao.adicionar("threads", quantidadeThreads);
+                medicao.adicionar("fragmentos", fragmentos);
+                medicao.adicionar("tempo_ns", duracao);
+                medicao.adicionar("operacoes_por_s", vazao);
+                // Só existe quando --threads inclui 1, antes das demais quantidades
+                if (vazaoUmaThread > 0) {
+                    medicao.adicionar("aceleracao", vazao / vazaoUmaThread);
+                }
+                medicao.adicionar("insercoes", soma.insercoes);
+                medicao.adicionar("buscas", soma.buscas);
+                medicao.adicionar("buscas_sucesso", soma.buscasComSucesso);
+                medicao.adicionar("redimensionamentos", tabela->obterRedimensionamentos());
+                memoria.adicionarMetricas(medicao);
+                relatorio.registrar(medicao);
+            }
+        }
+    };
+
+    auto criarDuplicacao = [](size_t fragmentos) {
+        return make_unique<TabelaFragmentada<Chave, int, TabelaDuplicacao<Chave>>>(fragmentos, 8, 0.7, 0.2);
+    };
+    auto criarAdaptativa = [](size_t fragmentos) {
+        return make_unique<TabelaFragmentada<Chave, int, TabelaAdaptativa<Chave>>>(fragmentos, 8, 0.7, 0.2);
+    };
+
+    vector<size_t> quantidadesFragmentos = {1};
+    if (opcoes.fragmentos > 1) {
+        quantidadesFragmentos.push_back(opcoes.fragmentos);
+    }
+    for (size_t fragmentos : quantidadesFragmentos) {
+        if (opcoes.estrategiaSelecionada("duplicacao")) medir("DUPLICAÇÃO", fragmentos, criarDuplicacao);
+        if (opcoes.estrategiaSelecionada("adaptativa")) medir("ADAPTATIVA", fragmentos, criarAdaptativa);
+    }
+}
+
+// TESTE 9: LEITORES CONCORRENTES COM UM ESCRITOR
+// n / 10 chaves estáveis nunca saem da tabela; um escritor insere e remove em ciclo
+// outras n / 10 chaves, o que dobra e reduz a tabela a cada volta. Cada leitor faz n
+// buscas: 3 de cada 4 em chaves estáveis, que precisam ser achadas com o valor certo,
+// e 1 em chaves do escritor, que se achadas precisam ter o valor certo. Qualquer
+// divergência (chave perdida ou valor rasgado durante o redimensionamento) conta em erros,
+// é relatada em cerr e devolvida
+template <typename Tabela>
+size_t medirLeitoresEscritor(Relatorio& relatorio, const string& nome, Tabela& tabela, size_t total,
+                           int leitores, int repeticao, uint64_t semente, double& vazaoUmLeitor) {
+    int estaveis = max((int)(total / 10), 1);
+    for (int chave = 0; chave < estaveis; chave++) {
+        tabela.inserir(chave, chave * 2 + 1);
+    }
+    size_t redimensionamentosAntes = tabela.obterRedimensionamentos();
+
+    atomic<int> prontas(0);
+    atomic<bool> largada(false);
+    atomic<bool> parar(false);
+    atomic<size_t> erros(0);
+    size_t escritas = 0;
+    vector<thread> threads;
+
+    threads.emplace_back([&] {
+        prontas++;
+        while (!largada.load(memory_order_acquire)) {
+            this_thread::yield();
+        }
+        while (!parar.load(memory_order_relaxed)) {
+            for (int chave = estaveis; chave < 2 * estaveis && !parar.load(memory_order_relaxed); chave++) {
+                tabela.inserir(chave, chave * 3 + 1);
+                escritas++;
+            }
+            for (int chave = estaveis; chave < 2 * estaveis && !parar.load(memory_order_relaxed); chave++) {
+                tabela.remover(chave);
+                escritas++;
+            }
+        }
+    });
+
+    for (int t = 0; t < leitores; t++) {
+        threads.emplace_back([&, t] {
+            mt19937_64 gerador(semente + t);
+            uniform_int_distribution<> distChaves(0, estaveis - 1);
+            size_t errosLocais = 0;
+
+            prontas++;
+            while (!largada.load(memory_order_acquire)) {
+                this_thread::yield();
+            }
+
+            for (size_t i = 0; i < total; i++) {
+                int chave = distChaves(gerador);
+                int valor = -1;
+                if (i % 4 != 3) {
+                    if (!tabela.buscar(chave, valor) || valor != chave * 2 + 1) {
+                        errosLocais++;
+                    }
+                } else {
+                    chave += estaveis;
+                    if (tabela.buscar(chave, valor) && valor != chave * 3 + 1) {
+                        errosLocais++;
+                    }
+                }
+            }
+            erros += errosLocais;
+        });
+    }
+
+    while (prontas.load() < leitores + 1) {
+        this_thread::yield();
+    }
+    long long inicio = agoraNs();
+    largada.store(true, memory_order_release);
+    for (size_t t = 1; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    long long duracao = agoraNs() - inicio;
+    parar.store(true);
+    threads[0].join();
+
+    double vazao = duracao > 0 ? (double)total * leitores * 1e9 / duracao : 0.0;
+    if (leitores == 1) {
+        vazaoUmLeitor = vazao;
+    }
+
+    Medicao medicao("leitores_escritor", "INTEIRAS", nome, total, repeticao);
+    medicao.variante = to_string(leitores) + " LEITOR" + (leitores > 1 ? "ES" : "");
+    medicao.adicionar("leitores", leitores);
+    medicao.adicionar("tempo_ns", duracao);
+    medicao.adicionar("leituras_por_s", vazao);
+    if (vazaoUmLeitor > 0) {
+        medicao.adicionar("aceleracao", vazao / vazaoUmLeitor);
+    }
+    medicao.adicionar("escritas", escritas);
+    medicao.adicionar("redimensionamentos", tabela.obterRedimensionamentos() - redimensionamentosAntes);
+    medicao.adicionar("erros", erros.load());
+    relatorio.registrar(medicao);
+
+    if (erros.load() > 0) {
+        cerr << "Erro: Teste 9, " << nome << " com " << leitores << " leitor" << (leitores > 1 ? "es" : "")
+             << " (repetição " << repeticao << "): " << erros.load()
+             << " leituras divergentes (chave perdida ou valor rasgado)" << endl;
+    }
+    return erros.load();
+}
+
+// Devolve o total de leituras divergentes de todas as execuções
+// Cada leitor da RCU ocupa um slot da reclamação por épocas enquanto vive; o escritor e a
+// thread principal podem ocupar outros dois
+const int MAXIMO_LEITORES = ReclamacaoEpocas::MAXIMO_THREADS - 2;
+
+size_t executarTeste9(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 9: LEITORES CONCORRENTES COM UM ESCRITOR, " + to_string(total) + " BUSCAS POR LEITOR");
+
+    // --threads aceita mais que isso: as quantidades acima viram o máximo, uma vez só
+    vector<int> quantidadesLeitores;
+    for (int leitores : opcoes.threadsOuPadrao()) {
+        if (leitores > MAXIMO_LEITORES) {
+            cerr << "Aviso: Teste 9 limita " << leitores << " leitores a " << MAXIMO_LEITORES
+                 << " (slots da reclamação por épocas)" << endl;
+            leitores = MAXIMO_LEITORES;
+        }
+        if (find(quantidadesLeitores.begin(), quantidadesLeitores.end(), leitores) == quantidadesLeitores.end()) {
+            quantidadesLeitores.push_back(leitores);
+        }
+    }
+
+    size_t erros = 0;
+    for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+        double vazaoUmLeitor = 0;
+        for (int leitores : quantidadesLeitores) {
+            TabelaRcu<int> tabela(8, 0.7, 0.2);
+            erros += medirLeitoresEscritor(relatorio, "RCU", tabela, total, leitores, repeticao, opcoes.semente,
+                                           vazaoUmLeitor);
+        }
+
+        vazaoUmLeitor = 0;
+        for (int leitores : quantidadesLeitores) {
+            TabelaFragmentada<int, int, TabelaDuplicacao<int>> tabela(opcoes.fragmentos, 8, 0.7, 0.2);
+            erros += medirLeitoresEscritor(relatorio, "FRAGMENTADA", tabela, total, leitores, repeticao,
+                                           opcoes.semente, vazaoUmLeitor);
+        }
+    }
+    return erros;
+}
+
+// TESTE 10: RETORNO À SONDAGEM ÚNICA DEPOIS DE UMA RAJADA
+// Insere pelo menos n chaves e para na inserção que começa um redimensionamento; daí em
+// diante só há buscas. Na migração dirigida por inserções a tabela nunca sai das duas
+// tabelas (retorno_ns = -1); com a ajudante em segundo plano, retorno_ns é o tempo entre
+// o fim da rajada e a primeira busca que encontra a migração concluída
+void medirRetornoMigracao(Relatorio& relatorio, const string& nome, TabelaIncremental<int>& tabela, size_t total,
+                          int repeticao, uint64_t semente) {
+    int inseridas = 0;
+    size_t eventosAntes;
+    do {
+        eventosAntes = tabela.obterEventosRedimensionamento().size();
+        tabela.inserir(inseridas, inseridas * 2);
+        inseridas++;
+    } while ((size_t)inseridas < total || tabela.obterEventosRedimensionamento().size() == eventosAntes);
+    long long fimRajada = agoraNs();
+
+    mt19937_64 gerador(semente);
+    uniform_int_distribution<> dist(0, inseridas - 1);
+    size_t acertos = 0;
+    size_t buscasMigrando = total;
+    long long retorno = -1;
+
+    for (size_t i = 0; i < total; i++) {
+        int valor;
+        if (tabela.buscar(dist(gerador), valor)) {
+            acertos++;
+        }
+        if (retorno < 0 && !tabela.estaMigrando()) {
+            retorno = agoraNs() - fimRajada;
+            buscasMigrando = i + 1;
+        }
+    }
+    long long duracao = agoraNs() - fimRajada;
+
+    Medicao medicao("retorno_migracao", "INTEIRAS", nome, total, repeticao);
+    medicao.adicionar("rajada", inseridas);
+    medicao.adicionar("retorno_ns", retorno);
+    medicao.adicionar("buscas_migrando", buscasMigrando);
+    medicao.adicionar("ns_busca_migrando", (double)(retorno < 0 ? duracao : retorno) / buscasMigrando);
+    if (buscasMigrando < total) {
+        medicao.adicionar("ns_busca_depois", (double)(duracao - retorno) / (total - buscasMigrando));
+    }
+    medicao.adicionar("acertos", acertos);
+    relatorio.registrar(medicao);
+}
+
+void executarTeste10(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 10: RETORNO À SONDAGEM ÚNICA APÓS RAJADA DE INSERÇÕES, n = " + to_string(total));
+
+    for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+        {
+            TabelaIncremental<int> tabela(8, 0.7, 0.2, 1000);
+            medirRetornoMigracao(relatorio, "POR INSERÇÃO", tabela, total, repeticao, opcoes.semente);
+        }
+        {
+            TabelaIncremental<int> tabela(8, 0.7, 0.2, 1000, true);
+            medirRetornoMigracao(relatorio, "SEGUNDO PLANO", tabela, total, repeticao, opcoes.semente);
+        }
+    }
+}
+
+// TESTE 11: BUSCAS UMA A UMA × EM LOTE
+// Mesma tabela e mesma sequência de chaves aleatórias, consultadas uma a uma (como na
+// FASE 2 do Teste 3) e em lotes de LOTE_CONSULTAS com buscarLote. Enquanto a tabela cabe
+// no último nível de cache a diferença é só o laço; acima dele cada busca isolada espera
+// a sua falta de cache e o lote as sobrepõe. A inserção compara inserir com inserirLote
+const size_t LOTE_CONSULTAS = 256;
+
+// Capacidade do último nível de cache em bytes; 0 se o sistema não informa
+long long tamanhoCacheUltimoNivel() {
+#if defined(__GLIBC__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    long tamanho = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (tamanho <= 0) {
+        tamanho = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+    return max(0L, tamanho);
+#else
+    return 0;
+#endif
+}
+
+void executarTeste11(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 11: BUSCAS UMA A UMA × EM LOTE COM PRÉ-CARGA, n = " + to_string(total));
+
+    vector<int> chaves = gerarNumerosSequenciais(total);
+    vector<int> valores(total);
+    for (size_t i = 0; i < total; i++) {
+        valores[i] = chaves[i] * 2;
+    }
+
+    // As mesmas consultas para as duas formas de busca e todas as estratégias
+    mt19937_64 gerador(opcoes.semente);
+    uniform_int_distribution<> dist(0, (int)total - 1);
+    vector<int> consultas(total);
+    for (size_t i = 0; i < total; i++) {
+        consultas[i] = dist(gerador);
+    }
+    vector<int> resultados(LOTE_CONSULTAS);
+    bool encontrados[LOTE_CONSULTAS];
+
+    paraCadaEstrategia<int>(opcoes, [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            long long insercaoLote;
+            {
+                auto tabela = criarTabela();
+                long long inicio = agoraNs();
+                tabela->inserirLote(chaves.data(), valores.data(), total);
+                insercaoLote = agoraNs() - inicio;
+            }
+
+            MemoriaFase memoria;
+            memoria.iniciar();
+            auto tabela = criarTabela();
+
+            long long inicio = agoraNs();
+            for (size_t i = 0; i < total; i++) {
+                tabela->inserir(chaves[i], valores[i]);
+            }
+            long long insercao = agoraNs() - inicio;
+
+            size_t acertos = 0;
+            inicio = agoraNs();
+            for (size_t i = 0; i < total; i++) {
+                int valor;
+                if (tabela->buscar(consultas[i], valor)) {
+                    acertos++;
+                }
+            }
+            long long busca = agoraNs() - inicio;
+
+            size_t acertosLote = 0;
+            inicio = agoraNs();
+            for (size_t base = 0; base < total; base += LOTE_CONSULTAS) {
+                acertosLote += tabela->buscarLote(consultas.data() + base, min(LOTE_CONSULTAS, total - base),
+                                                  resultados.data(), encontrados);
+            }
+            long long buscaLote = agoraNs() - inicio;
+
+            Medicao medicao("lote", "INTEIRAS", nome, total, repeticao);
+            medicao.adicionar("busca_ns_op", (double)busca / total);
+            medicao.adicionar("busca_lote_ns_op", (double)buscaLote / total);
+            medicao.adicionar("ganho_busca", (double)busca / max(1LL, buscaLote));
+            medicao.adicionar("insercao_ns_op", (double)insercao / total);
+            medicao.adicionar("insercao_lote_ns_op", (double)insercaoLote / total);
+            medicao.adicionar("acertos", acertos);
+            medicao.adicionar("acertos_lote", acertosLote);
+            medicao.adicionar("llc_bytes", tamanhoCacheUltimoNivel());
+            memoria.adicionarMetricas(medicao);
+            relatorio.registrar(medicao);
+        }
+    });
+}
+
+// TESTE 12: CARGA INICIAL EM BLOCO
+// n pares conhecidos de antemão, como na partida de um serviço: inseridos um a um a
+// partir da capacidade inicial (os rehashes sucessivos do Teste 1), com reservar(n)
+// antes, e com construirDe em 1, 2, 4... threads
+void executarTeste12(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 12: CARGA INICIAL DE " + to_string(total) + " PARES (UM A UM × RESERVAR × CONSTRUIR)");
+
+    vector<int> dados = gerarNumerosSequenciais(total);
+    vector<pair<int, int>> pares(total);
+    for (size_t i = 0; i < total; i++) {
+        pares[i] = {dados[i], dados[i] * 2};
+    }
+
+    paraCadaEstrategia<int>(opcoes, [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            auto medir = [&](const string& variante, auto&& carregar) {
+                MemoriaFase memoria;
+                memoria.iniciar();
+                auto tabela = criarTabela();
+
+                long long inicio = agoraNs();
+                carregar(*tabela);
+                long long duracao = agoraNs() - inicio;
+
+                Medicao medicao("carga_inicial", "INTEIRAS", nome, total, repeticao);
+                medicao.variante = variante;
+                medicao.adicionar("tempo_ns", duracao);
+                medicao.adicionar("ns_por_elemento", (double)duracao / total);
+                medicao.adicionar("redimensionamentos", tabela->obterRedimensionamentos());
+                medicao.adicionar("elementos", tabela->obterElementos());
+                medicao.adicionar("fator_carga", tabela->obterFatorCarga());
+                memoria.adicionarMetricas(medicao);
+                relatorio.registrar(medicao);
+            };
+
+            medir("UM A UM", [&](auto& tabela) {
+                for (const auto& [chave, valor] : pares) {
+                    tabela.inserir(chave, valor);
+                }
+            });
+            medir("RESERVAR", [&](auto& tabela) {
+                tabela.reservar(total);
+                for (const auto& [chave, valor] : pares) {
+                    tabela.inserir(chave, valor);
+                }
+            });
+            for (int threads : opcoes.threadsOuPadrao()) {
+                medir("CONSTRUIR T=" + to_string(threads),
+                      [&](auto& tabela) { tabela.construirDe(pares, (unsigned)threads); });
+            }
+        }
+    });
+}
+
+// TESTE 13: PRIMEIRA BUSCA DEPOIS DE REINICIAR
+// Reconstruir a tabela com inserir a cada partida contra abrir um instantâneo com mmap.
+// primeira_busca_ns vai do início até a primeira busca respondida; ns_busca é a média
+// das CONSULTAS_PARTIDA buscas seguintes, que no mapeamento ainda pagam páginas trazidas
+// do disco sob demanda (falhas_pagina). A reconstrução parte dos pares já na memória,
+// sem ler nenhum arquivo, o que só a favorece
+const size_t CONSULTAS_PARTIDA = 1000;
+
+// Tira as páginas do arquivo do cache do sistema, para a abertura ler do disco como
+// numa partida a frio; falso se o sistema não oferece isso
+bool descartarCacheArquivo(const string& arquivo) {
+#if defined(HASH_MMAP) && defined(POSIX_FADV_DONTNEED)
+    int descritor = open(arquivo.c_str(), O_RDONLY);
+    if (descritor < 0) return false;
+    // Páginas sujas não são descartadas: grava antes
+    bool descartado = fsync(descritor) == 0 && posix_fadvise(descritor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(descritor);
+    return descartado;
+#else
+    (void)arquivo;
+    return false;
+#endif
+}
+
+long long falhasPagina() {
+#if defined(HASH_MMAP)
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_minflt + uso.ru_majflt;
+#else
+    return 0;
+#endif
+}
+
+void executarTeste13(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 13: PRIMEIRA BUSCA APÓS REINICIAR (RECONSTRUIR × MMAP), n = " + to_string(total));
+
+    vector<int> dados = gerarNumerosSequenciais(total);
+    mt19937_64 gerador(opcoes.semente);
+    uniform_int_distribution<> dist(0, (int)total - 1);
+    vector<int> consultas(CONSULTAS_PARTIDA + 1);
+    for (int& consulta : consultas) {
+        consulta = dist(gerador);
+    }
+    const string& arquivo = opcoes.arquivoInstantaneo;
+
+    paraCadaEstrategia<int>(opcoes, [&](const string& nome, auto criarTabela) {
+        for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+            // O que o serviço faz hoje a cada partida
+            long long gravacao;
+            {
+                MemoriaFase memoria;
+                memoria.iniciar();
+                long long inicio = agoraNs();
+                auto tabela = criarTabela();
+                for (size_t i = 0; i < total; i++) {
+                    tabela->inserir(dados[i], dados[i] * 2);
+                }
+                int valor;
+                tabela->buscar(consultas[0], valor);
+                long long primeira = agoraNs() - inicio;
+
+                size_t acertos = 0;
+                long long inicioBuscas = agoraNs();
+                for (size_t i = 1; i <= CONSULTAS_PARTIDA; i++) {
+                    acertos += tabela->buscar(consultas[i], valor);
+                }
+                long long buscas = agoraNs() - inicioBuscas;
+
+                Medicao medicao("instantaneo", "INTEIRAS", nome, total, repeticao);
+                medicao.variante = "RECONSTRUIR";
+                medicao.adicionar("primeira_busca_ns", primeira);
+                medicao.adicionar("ns_busca", (double)buscas / CONSULTAS_PARTIDA);
+                medicao.adicionar("acertos", acertos);
+                memoria.adicionarMetricas(medicao);
+                relatorio.registrar(medicao);
+
+                inicio = agoraNs();
+                if (!TabelaMapeada<int>::gravar(*tabela, nome, arquivo)) {
+                    cerr << "Erro: não foi possível gravar o instantâneo em " << arquivo << endl;
+                    return;
+                }
+                gravacao = agoraNs() - inicio;
+            }
+
+            bool frio = descartarCacheArquivo(arquivo);
+            MemoriaFase memoria;
+            memoria.iniciar();
+            long long falhasAntes = falhasPagina();
+
+            long long inicio = agoraNs();
+            TabelaMapeada<int> mapa;
+            if (!mapa.abrir(arquivo)) {
+                cerr << "Erro: não foi possível abrir o instantâneo " << arquivo << endl;
+                return;
+            }
+            int valor;
+            mapa.buscar(consultas[0], valor);
+            long long primeira = agoraNs() - inicio;
+
+            size_t acertos = 0;
+            long long inicioBuscas = agoraNs();
+            for (size_t i = 1; i <= CONSULTAS_PARTIDA; i++) {
+                acertos += mapa.buscar(consultas[i], valor);
+            }
+            long long buscas = agoraNs() - inicioBuscas;
+
+            Medicao medicao("instantaneo", "INTEIRAS", nome, total, repeticao);
+            medicao.variante = "MAPEAR";
+            medicao.adicionar("primeira_busca_ns", primeira);
+            medicao.adicionar("ns_busca", (double)buscas / CONSULTAS_PARTIDA);
+            medicao.adicionar("acertos", acertos);
+            medicao.adicionar("gravacao_ns", gravacao);
+            medicao.adicionar("arquivo_bytes", mapa.obterBytes());
+            medicao.adicionar("falhas_pagina", falhasPagina() - falhasAntes);
+            medicao.adicionar("cache_frio", frio ? 1 : 0);
+            memoria.adicionarMetricas(medicao);
+            relatorio.registrar(medicao);
+
+            mapa.fechar();
+            remove(arquivo.c_str());
+        }
+    });
+}
+
+// TESTE 14: CONTROLE DO REDIMENSIONAMENTO POR FASES
+// A TabelaAdaptativa com as regras originais e com o controlador de custo na mesma
+// sequência de fases: rajada de n inserções, 2n buscas, remoção de 90% das chaves, 2n
+// buscas, nova rajada de n e 2n buscas. As buscas acham a chave 9 em 10 vezes. Cada fase
+// reporta o tempo, os rehashes que pagou e o estado em que deixou a tabela
+template <typename Tabela>
+void medirFasesControle(const OpcoesExecucao& opcoes, Relatorio& relatorio, const string& nome, size_t total,
+                        int repeticao) {
+    Tabela tabela;
+    mt19937_64 gerador(opcoes.semente);
+    int n = (int)total;
+    int primeira = 0;  // as chaves vivas são [primeira, proxima)
+    int proxima = 0;
+    long long tempoTotal = 0;
+    size_t operacoesTotal = 0;
+    
+    auto fase = [&](const string& variante, size_t operacoes, auto&& executar) {
+        size_t eventosAntes = tabela.obterEventosRedimensionamento().size();
+        MemoriaFase memoria;
+        memoria.iniciar();
+        long long inicio = agoraNs();
+        executar();
+        long long duracao = agoraNs() - inicio;
+        tempoTotal += duracao;
+        operacoesTotal += operacoes;
+        
+        const vector<EventoRedimensionamento>& eventos = tabela.obterEventosRedimensionamento();
+        size_t movidos = 0;
+        for (size_t i = eventosAntes; i < eventos.size(); i++) {
+            movidos += eventos[i].elementosMovidos;
+        }
+        EstatisticasTabela estatisticas = tabela.obterEstatisticas();
+        MedidorMemoria::Instantaneo agora = MedidorMemoria::ler();
+        
+        Medicao medicao("fases_controle", "INTEIRAS", nome, total, repeticao);
+        medicao.variante = variante;
+        medicao.adicionar("tempo_ns", duracao);
+        medicao.adicionar("ns_por_operacao", (double)duracao / operacoes);
+        medicao.adicionar("redimensionamentos", eventos.size() - eventosAntes);
+        medicao.adicionar("elementos_movidos", movidos);
+        medicao.adicionar("fator_carga", tabela.obterFatorCarga());
+        medicao.adicionar("sondas_acerto", estatisticas.sondasAcerto);
+        medicao.adicionar("sondas_falha", estatisticas.sondasFalha);
+        medicao.adicionar("bytes_por_elemento", (double)agora.bytesVivos / max((size_t)1, tabela.obterElementos()));
+        medicao.adicionar("bytes_pico", agora.bytesPico);
+        relatorio.registrar(medicao);
+    };
+    
+    auto rajada = [&] {
+        for (int i = 0; i < n; i++, proxima++) {
+            tabela.inserir(proxima, proxima * 2);
+        }
+    };
+    auto leitura = [&] {
+        // Um décimo do intervalo sorteado fica depois da última chave: buscas sem acerto
+        int vivas = proxima - primeira;
+        uniform_int_distribution<int> dist(primeira, proxima + vivas / 9);
+        size_t acertos = 0;
+        for (int i = 0; i < 2 * n; i++) {
+            int valor;
+            acertos += tabela.buscar(dist(gerador), valor);
+        }
+        volatile size_t sumidouro = acertos;
+        (void)sumidouro;
+    };
+    auto remocao = [&] {
+        int fim = primeira + (proxima - primeira) * 9 / 10;
+        for (; primeira < fim; primeira++) {
+            tabela.remover(primeira);
+        }
+    };
+    
+    fase("1 RAJADA", total, rajada);
+    fase("2 LEITURA", 2 * total, leitura);
+    size_t removidas = (size_t)(proxima - primeira) * 9 / 10;
+    fase("3 REMOÇÃO", removidas, remocao);
+    fase("4 LEITURA", 2 * total, leitura);
+    fase("5 RAJADA", total, rajada);
+    fase("6 LEITURA", 2 * total, leitura);
+    
+    size_t movidos = 0;
+    for (const EventoRedimensionamento& evento : tabela.obterEventosRedimensionamento()) {
+        movidos += evento.elementosMovidos;
+    }
+    Medicao medicao("fases_controle", "INTEIRAS", nome, total, repeticao);
+    medicao.variante = "TOTAL";
+    medicao.adicionar("tempo_ns", tempoTotal);
+    medicao.adicionar("ns_por_operacao", (double)tempoTotal / operacoesTotal);
+    medicao.adicionar("redimensionamentos", tabela.obterRedimensionamentos());
+    medicao.adicionar("elementos_movidos", movidos);
+    relatorio.registrar(medicao);
+}
+
+void executarTeste14(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 14: CONTROLE DO REDIMENSIONAMENTO POR FASES, n = " + to_string(total));
+    
+    using Regras = TabelaAdaptativa<int, int, HashChave<int>, equal_to<>, HashBase,
+                                    AlocadorContado<Elemento<int, int>>, ControladorRegras>;
+    for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+        medirFasesControle<Regras>(opcoes, relatorio, "REGRAS", total, repeticao);
+        medirFasesControle<TabelaAdaptativa<int>>(opcoes, relatorio, "CUSTO", total, repeticao);
+    }
+}
+
+// TESTE 15: OSCILAÇÃO NA FRONTEIRA DE REDIMENSIONAMENTO
+// Cada estratégia é levada a uma fronteira e oscila em volta dela com amplitude chaves
+// por ciclo, o padrão que faz uma política sem histerese redimensionar duas vezes a cada
+// ciclo. CRESCER: chaves até o primeiro redimensionamento depois de n/2, e cada ciclo
+// remove as mais novas e as insere de novo. ENCOLHER: daí, remoções até a tabela
+// encolher, e cada ciclo insere chaves novas e as remove. movidos_por_insercao são os
+// elementos rehashados na oscilação por chave inserida nela; movidos_por_insercao_total
+// conta também a preparação
+template <typename Tabela>
+void medirOscilacao(Relatorio& relatorio, const string& nome, Tabela& tabela, size_t total, bool encolher,
+                    size_t amplitude, const string& variante, int repeticao) {
+    const size_t CICLOS = 100;
+    const vector<EventoRedimensionamento>& eventos = tabela.obterEventosRedimensionamento();
+    // Um evento incremental ainda aberto continua somando elementos movidos
+    auto somarMovidos = [&] {
+        size_t movidos = 0;
+        for (const EventoRedimensionamento& evento : eventos) {
+            movidos += evento.elementosMovidos;
+        }
+        return movidos;
+    };
+    int proxima = 0;
+    
+    // A estática nunca redimensiona: para em n chaves e, encolhendo, sem nenhuma
+    size_t eventosAntes = 0;
+    while ((size_t)proxima < total && !(proxima >= (int)total / 2 && eventos.size() > eventosAntes)) {
+        eventosAntes = eventos.size();
+        tabela.inserir(proxima, proxima * 2);
+        proxima++;
+    }
+    size_t insercoes = proxima;
+    if (encolher) {
+        eventosAntes = eventos.size();
+        while (proxima > 0 && eventos.size() == eventosAntes) {
+            proxima--;
+            tabela.remover(proxima);
+        }
+    }
+    
+    eventosAntes = eventos.size();
+    size_t movidosAntes = somarMovidos();
+    int base = encolher ? proxima : proxima - (int)amplitude;
+    int fim = base + (int)amplitude;
+    long long inicio = agoraNs();
+    for (size_t ciclo = 0; ciclo < CICLOS; ciclo++) {
+        if (encolher) {
+            for (int chave = base; chave < fim; chave++) {
+                tabela.inserir(chave, chave * 3);
+            }
+        }
+        for (int chave = fim - 1; chave >= base; chave--) {
+            tabela.remover(chave);
+        }
+        if (!encolher) {
+            for (int chave = base; chave < fim; chave++) {
+                tabela.inserir(chave, chave * 3);
+            }
+        }
+    }
+    long long duracao = agoraNs() - inicio;
+    
+    size_t movidosTotal = somarMovidos();
+    size_t operacoes = 2 * CICLOS * amplitude;
+    insercoes += CICLOS * amplitude;
+    
+    Medicao medicao("oscilacao", "INTEIRAS", nome, total, repeticao);
+    medicao.variante = variante;
+    medicao.adicionar("elementos", tabela.obterElementos());
+    medicao.adicionar("operacoes", operacoes);
+    medicao.adicionar("tempo_ns", duracao);
+    medicao.adicionar("ns_por_operacao", (double)duracao / operacoes);
+    medicao.adicionar("redimensionamentos", eventos.size() - eventosAntes);
+    medicao.adicionar("elementos_movidos", movidosTotal - movidosAntes);
+    medicao.adicionar("movidos_por_insercao", (double)(movidosTotal - movidosAntes) / (CICLOS * amplitude));
+    medicao.adicionar("movidos_por_insercao_total", (double)movidosTotal / insercoes);
+    medicao.adicionar("fator_carga", tabela.obterFatorCarga());
+    relatorio.registrar(medicao);
+}
+
+void executarTeste15(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 15: OSCILAÇÃO NA FRONTEIRA DE REDIMENSIONAMENTO, n = " + to_string(total));
+    
+    // Uma chave, 1% e 10% de n por ciclo
+    vector<pair<string, size_t>> amplitudes = {
+        {"A=1", 1}, {"A=1%", max((size_t)1, total / 100)}, {"A=10%", max((size_t)1, total / 10)}};
+    
+    auto medir = [&](const string& nome, auto criarTabela) {
+        for (bool encolher : {false, true}) {
+            for (const auto& [amplitude, chaves] : amplitudes) {
+                string variante = (encolher ? "ENCOLHER " : "CRESCER ") + amplitude;
+                for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+                    auto tabela = criarTabela();
+                    medirOscilacao(relatorio, nome, *tabela, total, encolher, chaves, variante, repeticao);
+                }
+            }
+        }
+    };
+    paraCadaEstrategia<int>(opcoes, medir);
+    
+    // Carga mínima acima da metade da máxima: sem histerese, cada ciclo encolhe e cresce
+    if (opcoes.estrategiaSelecionada("duplicacao")) {
+        medir("DUPLICAÇÃO MÍN 0.4 SEM HISTERESE", [] {
+            return make_unique<TabelaDuplicacao<int>>(8, 0.7, 0.4, HistereseRedimensionamento::nenhuma());
+        });
+        medir("DUPLICAÇÃO MÍN 0.4", [] { return make_unique<TabelaDuplicacao<int>>(8, 0.7, 0.4); });
+    }
+}
+
+// TESTE 16: FORMA DO BALDE
+// A tabela por duplicação com a list e com K = 1, 2 e 4 elementos embutidos no vetor de
+// baldes, nas mesmas chaves. Fase 1 insere n, fase 2 busca n chaves presentes em ordem
+// aleatória, fase 3 n ausentes e fase 4 remove n / 2 e insere n / 2 novas. A memória é a
+// da tabela depois da fase 1; fora_do_vetor é a fração dos elementos guardada fora do
+// vetor de baldes (nós da list, transbordo dos embutidos), cada um uma falta de cache a
+// mais no acerto. Com --contadores-hw, cada fase é cercada pelos contadores de hardware
+template <typename Chave, typename FormaBalde>
+void medirFormaBalde(Relatorio& relatorio, ContadoresHardware* hardware, vector<Medicao>& contadores,
+                     const vector<Chave>& universo, const vector<size_t>& ordem, size_t total, int repeticao) {
+    using Tabela = TabelaDuplicacao<Chave, int, HashChave<Chave>, equal_to<>, HashBase,
+                                    AlocadorContado<Elemento<Chave, int>>, SemInstrumentacao, FormaBalde>;
+    const string nome = FormaBalde::nome();
+    
+    MedidorMemoria::Instantaneo antes = MedidorMemoria::ler();
+    Tabela tabela;
+    long long duracoes[4];
+    size_t operacoes[4] = {total, total, total, total / 2 + total / 2};
+    
+    auto fase = [&](int numero, auto&& trabalho) {
+        if (hardware) {
+            hardware->iniciar();
+        }
+        long long inicio = agoraNs();
+        trabalho();
+        duracoes[numero - 1] = agoraNs() - inicio;
+        
+        vector<ContadoresHardware::Leitura> leituras;
+        if (hardware) {
+            leituras = hardware->parar();
+        }
+        if (!leituras.empty()) {
+            Medicao medicao("forma_balde_hardware", FabricaChave<Chave>::nome(), nome, total, repeticao);
+            medicao.variante = "FASE " + to_string(numero);
+            for (const ContadoresHardware::Leitura& leitura : leituras) {
+                medicao.adicionar(leitura.nome + "_por_operacao", (double)leitura.valor / operacoes[numero - 1]);
+            }
+            contadores.push_back(medicao);
+        }
+    };
+    
+    size_t acertos = 0;
+    fase(1, [&] {
+        for (size_t i = 0; i < total; i++) {
+            tabela.inserir(universo[i], (int)i);
+        }
+    });
+    MedidorMemoria::Instantaneo depois = MedidorMemoria::ler();
+    EstatisticasTabela estatisticas = tabela.obterEstatisticas();
+    fase(2, [&] {
+        for (size_t i : ordem) {
+            int valor;
+            acertos += tabela.buscar(FabricaChave<Chave>::consulta(universo[i]), valor);
+        }
+    });
+    fase(3, [&] {
+        for (size_t i : ordem) {
+            int valor;
+            acertos += tabela.buscar(FabricaChave<Chave>::consulta(universo[total + i]), valor);
+        }
+    });
+    fase(4, [&] {
+        for (size_t i = 0; i < total / 2; i++) {
+            tabela.remover(FabricaChave<Chave>::consulta(universo[i]));
+        }
+        for (size_t i = total; i < total + total / 2; i++) {
+            tabela.inserir(universo[i], (int)i);
+        }
+    });
+    
+    // Elementos além dos EMBUTIDOS primeiros de cada cadeia
+    size_t fora = 0;
+    for (size_t c = FormaBalde::EMBUTIDOS + 1; c < estatisticas.histograma.size(); c++) {
+        fora += (c - FormaBalde::EMBUTIDOS) * estatisticas.histograma[c];
+    }
+    
+    Medicao medicao("forma_balde", FabricaChave<Chave>::nome(), nome, total, repeticao);
+    medicao.adicionar("bytes_balde", sizeof(typename FormaBalde::template Tipo<Elemento<Chave, int>,
+                                                                               AlocadorContado<Elemento<Chave, int>>>));
+    medicao.adicionar("bytes_por_elemento", (double)(depois.bytesVivos - antes.bytesVivos) / total);
+    medicao.adicionar("reservados_por_elemento", (double)(depois.bytesReservados - antes.bytesReservados) / total);
+    medicao.adicionar("alocacoes_por_elemento", (double)(depois.alocacoes - antes.alocacoes) / total);
+    medicao.adicionar("fora_do_vetor", (double)fora / estatisticas.elementos);
+    medicao.adicionar("fator_carga", estatisticas.elementos / (double)estatisticas.capacidade);
+    medicao.adicionar("insercao_ns", (double)duracoes[0] / operacoes[0]);
+    medicao.adicionar("acerto_ns", (double)duracoes[1] / operacoes[1]);
+    medicao.adicionar("falha_ns", (double)duracoes[2] / operacoes[2]);
+    medicao.adicionar("troca_ns", (double)duracoes[3] / operacoes[3]);
+    medicao.adicionar("acertos", acertos);
+    relatorio.registrar(medicao);
+}
+
+template <typename Chave>
+void executarTeste16(const OpcoesExecucao& opcoes, Relatorio& relatorio, size_t total) {
+    relatorio.secao("TESTE 16: FORMA DO BALDE, n = " + to_string(total) + " (CHAVES " +
+                    FabricaChave<Chave>::nome() + ")");
+    
+    // Presentes em [0, n), ausentes em [n, 2n)
+    vector<Chave> universo = gerarChaves<Chave>(gerarNumerosSequenciais(2 * total));
+    vector<size_t> ordem(total);
+    mt19937_64 gerador(opcoes.semente);
+    uniform_int_distribution<size_t> dist(0, total - 1);
+    for (size_t& i : ordem) {
+        i = dist(gerador);
+    }
+    
+    unique_ptr<ContadoresHardware> hardware;
+    if (opcoes.contadoresHardware) {
+        hardware = make_unique<ContadoresHardware>();
+        if (!hardware->disponivel()) {
+            cerr << "Aviso: contadores de hardware indisponíveis (" << hardware->obterMotivo() << ")" << endl;
+            hardware.reset();
+        }
+    }
+    
+    vector<Medicao> contadores;
+    for (int repeticao = 1; repeticao <= opcoes.repeticoes; repeticao++) {
+        medirFormaBalde<Chave, BaldeLista>(relatorio, hardware.get(), contadores, universo, ordem, total, repeticao);
+        medirFormaBalde<Chave, BaldeEmbutido<1>>(relatorio, hardware.get(), contadores, universo, ordem, total,
+                                                 repeticao);
+        medirFormaBalde<Chave, BaldeEmbutido<2>>(relatorio, hardware.get(), contadores, universo, ordem, total,
+                                                 repeticao);
+        medirFormaBalde<Chave, BaldeEmbutido<4>>(relatorio, hardware.get(), contadores, universo, ordem, total,
+                                                 repeticao);
+    }
+    for (const Medicao& medicao : contadores) {
+        relatorio.registrar(medicao);
+    }
+}
+
+// PROGRAMA PRINCIPAL
+int main(int argc, char* argv[]) {
+    OpcoesExecucao opcoes;
+    string erro;
+    if (!lerOpcoes(argc, argv, opcoes, erro)) {
+        cerr << "Erro: " << erro << endl;
+        imprimirUso(cerr);
+        return 1;
+    }
+    if (opcoes.ajuda) {
+        imprimirUso(cout);
+        return 0;
+    }
+
+    ofstream arquivo;
+    if (!opcoes.arquivoSaida.empty()) {
+        arquivo.open(opcoes.arquivoSaida);
+        if (!arquivo) {
+            cerr << "Erro: não foi possível abrir " << opcoes.arquivoSaida << endl;
+            return 1;
+        }
+    }
+
+    Relatorio relatorio(opcoes.formato, opcoes.arquivoSaida.empty() ? cout : arquivo, opcoes.semente);
+    relatorio.iniciar();
+
+    if (relatorio.texto()) {
+        relatorio.fluxo() << "==================================================================" << endl
+        << "EXPERIMENTO: DIMENSIONAMENTO DINÂMICO EM TABELAS HASH" << endl
+        << "Comparação de 9 Estratégias" << endl
+        << "Semente: " << opcoes.semente << ", repetições: " << opcoes.repeticoes
+        << ", sondagem SIMD: " << nomeNivelSimd(detectarNivelSimd()) << endl
+        << "Tempos em nanossegundos" << endl
+        << "==================================================================" << endl;
+    }
+
+    size_t errosConcorrencia = 0;  // leituras divergentes do Teste 9
+    for (int teste : opcoes.testes) {
+        if (opcoes.pausar) {
+            cerr << endl << "Pressione ENTER para iniciar o Teste " << teste << endl;
+            cin.get();
+        }
+
+        switch (teste) {
+            case 1:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    if (opcoes.chaveSelecionada("int")) executarTeste1<int>(opcoes, relatorio, tamanho);
+                    if (opcoes.chaveSelecionada("texto")) executarTeste1<string>(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 2:
+                for (size_t tamanho : opcoes.tamanhosOu(500000)) {
+                    if (opcoes.chaveSelecionada("int")) executarTeste2<int>(opcoes, relatorio, tamanho);
+                    if (opcoes.chaveSelecionada("texto")) executarTeste2<string>(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 3:
+                for (size_t tamanho : opcoes.tamanhosOu(100000)) {
+                    if (opcoes.chaveSelecionada("int")) executarTeste3<int>(opcoes, relatorio, tamanho);
+                    if (opcoes.chaveSelecionada("texto")) executarTeste3<string>(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 4:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste4(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 5:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste5(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 6:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste6(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 7:
+                // Com --traco o tamanho vem do próprio arquivo
+                for (size_t tamanho : opcoes.arquivoTraco.empty() ? opcoes.tamanhosOu(500000) : vector<size_t>{0}) {
+                    vector<Carga> cargas;
+                    if (!prepararCargas(opcoes, tamanho, cargas, erro)) {
+                        cerr << "Erro: " << erro << endl;
+                        return 1;
+                    }
+                    if (opcoes.chaveSelecionada("int")) executarTeste7<int>(opcoes, relatorio, cargas);
+                    if (opcoes.chaveSelecionada("texto")) executarTeste7<string>(opcoes, relatorio, cargas);
+                }
+                break;
+            case 8:
+                for (size_t tamanho : opcoes.tamanhosOu(500000)) {
+                    if (opcoes.chaveSelecionada("int")) executarTeste8<int>(opcoes, relatorio, tamanho);
+                    if (opcoes.chaveSelecionada("texto")) executarTeste8<string>(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 9:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    errosConcorrencia += executarTeste9(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 10:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste10(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 11:
+                // Tamanhos abaixo e acima do último nível de cache
+                for (size_t tamanho : opcoes.tamanhos.empty() ? vector<size_t>{10000, 100000, 1000000, 4000000}
+                                                              : opcoes.tamanhos) {
+                    executarTeste11(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 12:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste12(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 13:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste13(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 14:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    executarTeste14(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 15:
+                for (size_t tamanho : opcoes.tamanhosOu(100000)) {
+                    executarTeste15(opcoes, relatorio, tamanho);
+                }
+                break;
+            case 16:
+                for (size_t tamanho : opcoes.tamanhosOu(1000000)) {
+                    if (opcoes.chaveSelecionada("int")) executarTeste16<int>(opcoes, relatorio, tamanho);
+                    if (opcoes.chaveSelecionada("texto")) executarTeste16<string>(opcoes, relatorio, tamanho);
+                }
+                break;
+        }
+    }
+
+    if (relatorio.texto()) {
+        relatorio.fluxo() << endl << "==================================================================" << endl
+        << "EXPERIMENTO CONCLUÍDO!" << endl
+        << "==================================================================" << endl;
+    }
+    relatorio.finalizar();
+
+    // Uma execução sem supervisão precisa notar leituras divergentes no Teste 9
+    if (errosConcorrencia > 0) {
+        cerr << "Erro: " << errosConcorrencia << " leituras divergentes no Teste 9" << endl;
+        return 2;
+    }
+    return 0;
+}